@@ -0,0 +1,65 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Eigen/Core>
+
+#include "spe.h"
+
+// Time a function and report the number of frames averaged per second
+template<class FUNCTION> void time( const std::string& label, const std::size_t frames, FUNCTION average )
+{
+    const auto start = std::chrono::steady_clock::now();
+    average();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>( stop - start ).count();
+    std::cout << "    " << label << ": " << frames / seconds << " frames/s" << std::endl;
+}
+
+// Average all frames of each given SPE file, adding up one frame at a time and then with the parallel reduction
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    for ( auto& filePath : filePaths ) {
+        SPE::File speFile( filePath );
+        std::cout << filePath << " (" << speFile.frames() << " frames):" << std::endl;
+
+        // Warm up the page cache
+        speFile.getAverageFrame();
+
+        time( "getFrame loop", speFile.frames(), [&]() {
+            Eigen::ArrayXXf averageFrame = Eigen::ArrayXXf::Zero( speFile.rows(), speFile.columns() );
+            for ( auto frame = 0u; frame < speFile.frames(); ++frame ) averageFrame += speFile.getFrame( frame );
+            averageFrame /= speFile.frames();
+        } );
+
+        for ( auto threads : { 1u, 2u, 4u, std::thread::hardware_concurrency() } ) {
+            time( "getAverageFrame, " + std::to_string( threads ) + " threads", speFile.frames(), [&]() {
+                speFile.getAverageFrame( threads );
+            } );
+        }
+    }
+
+    return 0;
+}
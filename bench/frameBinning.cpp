@@ -0,0 +1,79 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+#include "spe.h"
+
+// Time a function and report the number of frames binned per second
+template<class FUNCTION> void time( const std::string& label, const std::size_t frames, FUNCTION bin )
+{
+    const auto start = std::chrono::steady_clock::now();
+    bin();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>( stop - start ).count();
+    std::cout << "    " << label << ": " << frames / seconds << " frames/s" << std::endl;
+}
+
+// Bin a full frame into bins of groupx x groupy pixels
+Eigen::ArrayXXf bin( const Eigen::ArrayXXf& frame, const int groupx, const int groupy )
+{
+    Eigen::ArrayXXf binnedFrame( frame.rows() / groupy, frame.cols() / groupx );
+    for ( auto col = 0; col < binnedFrame.cols(); ++col ) {
+        for ( auto row = 0; row < binnedFrame.rows(); ++row ) {
+            binnedFrame( row, col ) = frame.block( row * groupy, col * groupx, groupy, groupx ).sum();
+        }
+    }
+    return binnedFrame;
+}
+
+// Bin every frame of each given SPE file 2 x 2, 4 x 4 and fully vertically, after getFrame() and then while decoding
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    for ( auto& filePath : filePaths ) {
+        SPE::File speFile( filePath );
+        std::cout << filePath << " (" << speFile.frames() << " frames):" << std::endl;
+
+        auto total = 0.0f;
+
+        for ( auto group : { std::make_pair( 2, 2 ), std::make_pair( 4, 4 ), std::make_pair( 1, int( speFile.rows() ) ) } ) {
+            const auto label = std::to_string( group.first ) + " x " + std::to_string( group.second );
+            if ( group.first > int( speFile.columns() ) or group.second > int( speFile.rows() ) ) continue;
+
+            time( "getFrame and bin, " + label, speFile.frames(), [&]() {
+                for ( auto frame = 0u; frame < speFile.frames(); ++frame ) total += bin( speFile.getFrame( frame ), group.first, group.second ).sum();
+            } );
+
+            time( "getBinnedFrame, " + label, speFile.frames(), [&]() {
+                for ( auto frame = 0u; frame < speFile.frames(); ++frame ) total += speFile.getBinnedFrame( frame, group.first, group.second ).sum();
+            } );
+        }
+
+        // Keep the work from being optimized away
+        if ( total != total ) std::cout << total << std::endl;
+    }
+
+    return 0;
+}
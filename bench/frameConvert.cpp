@@ -0,0 +1,83 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+#include "convert.h"
+
+const std::size_t ROWS = 2048;
+const std::size_t COLS = 2048;
+const auto REPEATS = 20;
+
+// Time a conversion and report the number of frames converted per second
+template<class FUNCTION> void time( const std::string& label, FUNCTION convert )
+{
+    convert();
+
+    const auto start = std::chrono::steady_clock::now();
+    for ( auto count = 0; count < REPEATS; ++count ) convert();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>( stop - start ).count();
+    std::cout << "    " << label << ": " << REPEATS / seconds << " frames/s" << std::endl;
+}
+
+// Convert a frame of the given datatype to floating point values, the old way and with the conversion kernels
+template<class T> void benchmark( const std::string& datatype )
+{
+    std::vector<T> pixels( ROWS * COLS );
+    for ( auto index = 0u; index < pixels.size(); ++index ) pixels.at( index ) = static_cast<T>( index % 4096 );
+
+    Eigen::ArrayXXf frameArray( ROWS, COLS );
+    std::vector<float> values( ROWS * COLS );
+
+    std::cout << datatype << " (" << ROWS << " x " << COLS << "):" << std::endl;
+
+    time( "per-pixel loop", [&]() {
+        auto count = 0;
+        for ( auto row = 0u; row < ROWS; ++row ) {
+            for ( auto col = 0u; col < COLS; ++col ) {
+                frameArray( row, col ) = pixels.at( count++ );
+            }
+        }
+    } );
+
+    time( "convertFrame, column-major", [&]() {
+        SPE::convertFrame( pixels.data(), frameArray.data(), ROWS, COLS );
+    } );
+
+    time( "convertPixels, row-major", [&]() {
+        SPE::convertPixels( pixels.data(), values.data(), values.size() );
+    } );
+}
+
+int main()
+{
+    std::cout << "Conversion instructions: " << SPE::conversionInstructions() << std::endl;
+
+    benchmark<float>( "float" );
+    benchmark<std::int32_t>( "long integer" );
+    benchmark<std::int16_t>( "short integer" );
+    benchmark<std::uint16_t>( "unsigned short integer" );
+
+    return 0;
+}
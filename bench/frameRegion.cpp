@@ -0,0 +1,80 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+#include "spe.h"
+
+// Time a function and report the number of regions fetched per second
+template<class FUNCTION> void time( const std::string& label, const std::size_t regions, FUNCTION fetch )
+{
+    const auto start = std::chrono::steady_clock::now();
+    fetch();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>( stop - start ).count();
+    std::cout << "    " << label << ": " << regions / seconds << " regions/s" << std::endl;
+}
+
+// Fetch a strip of 64 rows and a 64 x 64 window from every frame of each given SPE file, cut out of full frames and then read on their own
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    for ( auto& filePath : filePaths ) {
+        SPE::File speFile( filePath );
+        std::cout << filePath << " (" << speFile.frames() << " frames):" << std::endl;
+
+        const unsigned short rows = std::min<std::size_t>( speFile.rows(), 64 );
+        const unsigned short columns = std::min<std::size_t>( speFile.columns(), 64 );
+
+        auto total = 0.0f;
+
+        time( "getFrame block, strip", speFile.frames(), [&]() {
+            for ( auto frame = 0u; frame < speFile.frames(); ++frame ) total += speFile.getFrame( frame ).topRows( rows ).sum();
+        } );
+
+        time( "getFrameRegion, strip", speFile.frames(), [&]() {
+            for ( auto frame = 0u; frame < speFile.frames(); ++frame ) total += speFile.getFrameRegion( frame, 0, 0, rows, speFile.columns() ).sum();
+        } );
+
+        time( "getFrameRegions, strip", speFile.frames(), [&]() {
+            const auto stack = speFile.getFrameRegions( 0, speFile.frames(), 0, 0, rows, speFile.columns() );
+            total += stack.frame( 0 ).sum();
+        } );
+
+        time( "getFrame block, window", speFile.frames(), [&]() {
+            for ( auto frame = 0u; frame < speFile.frames(); ++frame ) total += speFile.getFrame( frame ).topLeftCorner( rows, columns ).sum();
+        } );
+
+        time( "getFrameRegions, window", speFile.frames(), [&]() {
+            const auto stack = speFile.getFrameRegions( 0, speFile.frames(), 0, 0, rows, columns );
+            total += stack.frame( 0 ).sum();
+        } );
+
+        // Keep the work from being optimized away
+        if ( total != total ) std::cout << total << std::endl;
+    }
+
+    return 0;
+}
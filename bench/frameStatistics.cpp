@@ -0,0 +1,71 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+#include "spe.h"
+
+// Time a function and report the number of frames processed per second
+template<class FUNCTION> void time( const std::string& label, const std::size_t frames, FUNCTION calculate )
+{
+    const auto start = std::chrono::steady_clock::now();
+    calculate();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>( stop - start ).count();
+    std::cout << "    " << label << ": " << frames / seconds << " frames/s" << std::endl;
+}
+
+// Calculate the per-pixel mean, variance, minimum and maximum of each given SPE file, one pass over getFrame() per statistic and then in a single pass
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    for ( auto& filePath : filePaths ) {
+        SPE::File speFile( filePath );
+        std::cout << filePath << " (" << speFile.frames() << " frames):" << std::endl;
+
+        // Warm up the page cache
+        speFile.getAverageFrame();
+
+        time( "getFrame passes", speFile.frames(), [&]() {
+            const auto mean = speFile.getAverageFrame();
+            Eigen::ArrayXXf variance = Eigen::ArrayXXf::Zero( speFile.rows(), speFile.columns() );
+            for ( auto frame = 0u; frame < speFile.frames(); ++frame ) variance += ( speFile.getFrame( frame ) - mean ).square();
+            variance /= speFile.frames();
+            Eigen::ArrayXXf minimum = speFile.getFrame( 0 );
+            for ( auto frame = 1u; frame < speFile.frames(); ++frame ) minimum = minimum.min( speFile.getFrame( frame ) );
+            Eigen::ArrayXXf maximum = speFile.getFrame( 0 );
+            for ( auto frame = 1u; frame < speFile.frames(); ++frame ) maximum = maximum.max( speFile.getFrame( frame ) );
+        } );
+
+        time( "getStatistics", speFile.frames(), [&]() {
+            speFile.getStatistics( SPE::Statistics::MEAN | SPE::Statistics::VARIANCE | SPE::Statistics::MINIMUM | SPE::Statistics::MAXIMUM );
+        } );
+
+        time( "getStatistics with median", speFile.frames(), [&]() {
+            speFile.getStatistics( SPE::Statistics::ALL );
+        } );
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+#include "spe.h"
+
+// Stand in for the work a reduction job does on each frame
+double process( const Eigen::ArrayXXf& frame )
+{
+    return frame.abs().sqrt().log1p().sum();
+}
+
+// Time a walk through all frames and report the number of frames processed per second
+template<class FUNCTION> void time( const std::string& label, const std::size_t frames, FUNCTION walk )
+{
+    const auto start = std::chrono::steady_clock::now();
+    walk();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>( stop - start ).count();
+    std::cout << "    " << label << ": " << frames / seconds << " frames/s" << std::endl;
+}
+
+// Walk through every frame of each given SPE file, fetching one frame at a time and then streaming them with read-ahead
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    for ( auto& filePath : filePaths ) {
+        SPE::File speFile( filePath );
+        std::cout << filePath << " (" << speFile.frames() << " frames):" << std::endl;
+
+        auto total = 0.0;
+
+        time( "getFrame loop", speFile.frames(), [&]() {
+            for ( auto frame = 0u; frame < speFile.frames(); ++frame ) total += process( speFile.getFrame( frame ) );
+        } );
+
+        for ( auto depth : { 1, 2, 4 } ) {
+            time( "FrameStream, depth " + std::to_string( depth ), speFile.frames(), [&]() {
+                for ( const auto& frame : SPE::FrameStream( speFile, depth ) ) total += process( frame );
+            } );
+        }
+
+        // Keep the work from being optimized away
+        if ( std::isnan( total ) ) std::cout << total << std::endl;
+    }
+
+    return 0;
+}
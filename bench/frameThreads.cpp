@@ -0,0 +1,59 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Eigen/Core>
+
+#include "spe.h"
+
+// Fetch every frame of each given SPE file through one SPE::File shared by a growing number of threads and report the number of frames fetched per second
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    for ( auto& filePath : filePaths ) {
+        SPE::File speFile( filePath );
+        std::cout << filePath << " (" << speFile.frames() << " frames):" << std::endl;
+
+        // Warm up the page cache
+        speFile.getAverageFrame();
+
+        for ( auto threads : { 1u, 2u, 4u, 8u } ) {
+            std::vector<float> totals( threads );
+
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> pool;
+            for ( auto thread = 0u; thread < threads; ++thread ) {
+                pool.emplace_back( [&, thread]() {
+                    for ( auto frame = thread; frame < speFile.frames(); frame += threads ) totals.at( thread ) += speFile.getFrame( frame )( 0, 0 );
+                } );
+            }
+            for ( auto& thread : pool ) thread.join();
+            const auto stop = std::chrono::steady_clock::now();
+
+            const auto seconds = std::chrono::duration<double>( stop - start ).count();
+            std::cout << "    " << threads << " threads: " << speFile.frames() / seconds << " frames/s" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+#include <unistd.h>
+
+#include "spe.h"
+#include "writer.h"
+
+// Time a function and report the number of megabytes of frame data written per second
+template<class FUNCTION> void time( const std::string& label, const std::size_t bytes, FUNCTION write )
+{
+    // Start from a fresh file, as truncating one with unwritten data may flush it first
+    unlink( "frameWrite.out" );
+
+    const auto start = std::chrono::steady_clock::now();
+    write();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>( stop - start ).count();
+    std::cout << "    " << label << ": " << bytes / 1e6 / seconds << " MB/s" << std::endl;
+}
+
+// Write all frames of each given SPE file to a new SPE file, copying them as stored and converting them from floating point values
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    const std::string outPath = "frameWrite.out";
+
+    for ( auto& filePath : filePaths ) {
+        SPE::File speFile( filePath );
+        const auto datatype = speFile.metadata.datatype();
+        const std::size_t bytes = speFile.rows() * speFile.columns() * speFile.frames() * ( ( datatype == 2 or datatype == 3 ) ? 2 : 4 );
+        std::cout << filePath << " (" << speFile.frames() << " frames):" << std::endl;
+
+        // Warm up the page cache
+        speFile.getAverageFrame();
+
+        time( "Writer, copy", bytes, [&]() {
+            SPE::Writer writer( outPath, speFile.rows(), speFile.columns(), datatype, speFile.metadata );
+            writer.write( speFile, 0, speFile.frames() );
+        } );
+
+        time( "Writer, getFrame loop", bytes, [&]() {
+            SPE::Writer writer( outPath, speFile.rows(), speFile.columns(), datatype, speFile.metadata );
+            for ( auto frame = 0u; frame < speFile.frames(); ++frame ) writer.write( speFile.getFrame( frame ) );
+        } );
+    }
+
+    unlink( outPath.c_str() );
+
+    return 0;
+}
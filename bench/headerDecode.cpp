@@ -0,0 +1,68 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "metadata.h"
+#include "fields.h"
+
+// Decode the header of each given SPE file over and over and report how many headers are decoded per second
+// Headers are decoded in full and then loaded lazily, decoding only the exposure time
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    const auto REPEATS = 20000;
+
+    for ( auto& filePath : filePaths ) {
+        std::ifstream file( filePath.c_str(), std::ios::in | std::ios::binary );
+        if ( not file.is_open() ) {
+            std::cerr << "Unable to open " << filePath << std::endl;
+            continue;
+        }
+
+        SPE::Metadata metadata;
+
+        // Warm up the page cache and the allocator
+        metadata.read( file );
+
+        const auto start = std::chrono::steady_clock::now();
+        for ( auto count = 0; count < REPEATS; ++count ) metadata.read( file );
+        const auto stop = std::chrono::steady_clock::now();
+
+        const auto seconds = std::chrono::duration<double>( stop - start ).count();
+        std::cout << filePath << ": " << REPEATS << " headers in " << seconds << " s, " << REPEATS / seconds << " headers/s" << std::endl;
+
+        const auto lazyStart = std::chrono::steady_clock::now();
+        for ( auto count = 0; count < REPEATS; ++count ) {
+            metadata.load( file );
+            metadata.get<SPE::Field::exp_sec>();
+        }
+        const auto lazyStop = std::chrono::steady_clock::now();
+
+        const auto lazySeconds = std::chrono::duration<double>( lazyStop - lazyStart ).count();
+        std::cout << filePath << ": " << REPEATS << " lazy headers in " << lazySeconds << " s, " << REPEATS / lazySeconds << " headers/s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "probe.h"
+
+// Probe each given SPE file over and over and report how many files are probed per second
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    const auto REPEATS = 100000;
+
+    for ( auto& filePath : filePaths ) {
+        auto result = SPE::probe( filePath );
+        std::cout << filePath << ": " << result.ydim << " rows x " << result.xdim << " cols x " << result.NumFrames << " frames, datatype " << result.datatype << ( result.valid ? ", valid" : ", invalid" ) << std::endl;
+
+        const auto start = std::chrono::steady_clock::now();
+        for ( auto count = 0; count < REPEATS; ++count ) result = SPE::probe( filePath );
+        const auto stop = std::chrono::steady_clock::now();
+
+        const auto seconds = std::chrono::duration<double>( stop - start ).count();
+        std::cout << filePath << ": " << REPEATS << " probes in " << seconds << " s, " << 60 * REPEATS / seconds << " files/min" << std::endl;
+    }
+
+    return 0;
+}
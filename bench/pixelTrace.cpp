@@ -0,0 +1,76 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+
+#include "spe.h"
+
+// Time a function and report the number of samples fetched per second
+template<class FUNCTION> void time( const std::string& label, const std::size_t samples, FUNCTION fetch )
+{
+    const auto start = std::chrono::steady_clock::now();
+    fetch();
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>( stop - start ).count();
+    std::cout << "    " << label << ": " << samples / seconds << " samples/s" << std::endl;
+}
+
+// Fetch the trace of the central pixel and of a handful of scattered pixels of each given SPE file, one getPixel() at a time and then as traces
+int main( int argc, char* argv[] )
+{
+    std::vector<std::string> filePaths;
+    for ( auto count = 1; count < argc; ++count ) filePaths.push_back( argv[ count ] );
+    if ( filePaths.empty() ) filePaths = { "../demo/image.spe", "../demo/spectrum.spe" };
+
+    for ( auto& filePath : filePaths ) {
+        SPE::File speFile( filePath );
+        std::cout << filePath << " (" << speFile.frames() << " frames):" << std::endl;
+
+        const unsigned short rows = speFile.rows();
+        const unsigned short columns = speFile.columns();
+        const std::vector<std::pair<unsigned short, unsigned short>> pixels = { { 0, 0 }, { rows / 4, columns / 4 }, { rows / 2, columns / 2 }, { rows - 1, columns - 1 } };
+
+        auto total = 0.0f;
+
+        time( "getPixel loop, 1 pixel", speFile.frames(), [&]() {
+            for ( auto frame = 0u; frame < speFile.frames(); ++frame ) total += speFile.getPixel( rows / 2, columns / 2, frame );
+        } );
+
+        time( "getPixelTrace, 1 pixel", speFile.frames(), [&]() {
+            total += speFile.getPixelTrace( rows / 2, columns / 2 ).sum();
+        } );
+
+        time( "getPixelTraces, 4 pixels", speFile.frames() * pixels.size(), [&]() {
+            total += speFile.getPixelTraces( pixels ).sum();
+        } );
+
+        speFile.map();
+        time( "getPixelTraces, 4 pixels, mapped", speFile.frames() * pixels.size(), [&]() {
+            total += speFile.getPixelTraces( pixels ).sum();
+        } );
+
+        // Keep the work from being optimized away
+        if ( total != total ) std::cout << total << std::endl;
+    }
+
+    return 0;
+}
@@ -49,6 +49,31 @@ struct CalibrationData : public Data
      */
     void read( std::ifstream& );
 
+    /*! \brief Read data from the header of an SPE file
+     *
+     * This method extracts the binary data comprising a calibration data block from the header that has already been read from an SPE file.
+     * The file itself is not accessed again.
+     */
+    void read( const Data& );
+
+    /*! \brief Write data to an SPE file
+     *
+     * This method stores the fields of a calibration data block as binary data and writes it to an SPE file opened for writing.
+     */
+    void write( std::ostream& );
+
+    /*! \brief Write data into the header of an SPE file
+     *
+     * This method stores the fields of a calibration data block as binary data and copies it into the header, ready to be written to an SPE file.
+     */
+    void write( Data& );
+
+    /*! \brief Compare the fields of two calibration data blocks
+     *
+     * Two blocks are equal if all their fields are, wherever they are stored in the header.
+     */
+    bool operator==( const CalibrationData& ) const;
+
     //! \brief offset for absolute data scaling
     double offset = 0.0;
 
@@ -99,6 +124,10 @@ struct CalibrationData : public Data
     std::string calib_label = std::string( std::string( 80, ' ' ) + '\0' );
 
     virtual void reset();
+
+    private:
+    void decode();
+    void encode();
 };
 }
 
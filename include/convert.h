@@ -0,0 +1,62 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_CONVERT_H
+#define SPE_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SPE {
+/*! \brief Convert pixel intensities to floating point values
+ *
+ * The given number of pixels are converted from the datatype used in the SPE file into floating point values, keeping their order.
+ * The conversion uses the widest vector instructions available on the processor (AVX2 or SSE2), chosen at runtime, and falls back to plain C++ otherwise.
+ *
+ * \param pixels The pixel intensities to convert
+ * \param values The converted values, with room for all pixels
+ * \param count The number of pixels to convert
+ */
+void convertPixels( const float* pixels, float* values, const std::size_t count );
+void convertPixels( const std::int32_t* pixels, float* values, const std::size_t count );
+void convertPixels( const std::int16_t* pixels, float* values, const std::size_t count );
+void convertPixels( const std::uint16_t* pixels, float* values, const std::size_t count );
+
+/*! \brief Convert a frame of pixel intensities to floating point values in column-major order
+ *
+ * SPE files store frames row-major, while Eigen arrays are column-major by default.
+ * This converts a row-major frame into a column-major frame of floating point values, such as the data of an Eigen::ArrayXXf.
+ * The frame is processed in small square blocks that fit in cache, converting each row of a block with SPE::convertPixels() before transposing it.
+ *
+ * \param pixels The pixel intensities to convert, row after row
+ * \param values The converted values, column after column, with room for all pixels
+ * \param rows The number of rows in the frame
+ * \param cols The number of columns in the frame
+ */
+void convertFrame( const float* pixels, float* values, const std::size_t rows, const std::size_t cols );
+void convertFrame( const std::int32_t* pixels, float* values, const std::size_t rows, const std::size_t cols );
+void convertFrame( const std::int16_t* pixels, float* values, const std::size_t rows, const std::size_t cols );
+void convertFrame( const std::uint16_t* pixels, float* values, const std::size_t rows, const std::size_t cols );
+
+/*! \brief Get the vector instructions used for conversion
+ *
+ * Returns "AVX2", "SSE2" or "scalar", depending on the instructions chosen for this processor.
+ */
+const char* conversionInstructions();
+}
+
+#endif
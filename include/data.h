@@ -18,11 +18,13 @@
 #ifndef SPE_DATA_H
 #define SPE_DATA_H
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <vector>
 #include <fstream>
+#include <ostream>
 #include <string>
-#include <sstream>
 
 namespace SPE {
 /*! \brief Binary data present in an SPE file
@@ -38,8 +40,17 @@ class Data
      * Both values are specified in bytes.
      */
     Data( const std::size_t, const std::size_t );
+    Data( const Data& ) = default;
     ~Data() = default;
 
+    /*! \brief Copy the binary data of another instance of data
+     *
+     * Only the stored bytes are copied; the offset in the file stays that of this instance.
+     * This lets a block such as a calibration be assigned to the block of another axis or of another header.
+     * Both instances must hold the same amount of data.
+     */
+    Data& operator=( const Data& );
+
     /*! \brief Read data from an opened SPE file
      *
      * This method extracts binary data from an open SPE file.
@@ -47,6 +58,22 @@ class Data
      */
     virtual void read( std::ifstream& );
 
+    /*! \brief Read data from another instance of data
+     *
+     * This method extracts binary data from another instance of data that has already been read from an SPE file.
+     * The other instance must span the bytes of this instance, as the header spans its ROI info blocks.
+     * The file itself is not accessed, so no additional reads are made.
+     */
+    virtual void read( const Data& );
+
+    /*! \brief Read data from an SPE file opened as a file descriptor
+     *
+     * This method extracts binary data from an SPE file using a single positioned read.
+     * The file position of the descriptor is neither used nor changed.
+     * If the data cannot be read completely, the extracted bytes are all left as zero.
+     */
+    virtual void read( const int );
+
     /*! \brief Extract meaningful information from binary data
      *
      * This template method will reinterpret the binary data read from the SPE file into a usable datatype.
@@ -56,18 +83,78 @@ class Data
      * Also, the length of data to be reinterpreted can be specified.
      * The default is to use the size of the value variable.
      *
+     * The bytes are copied directly out of the stored binary data.
+     * No temporary strings or streams are created, so retrieving a value never allocates memory.
+     *
      * \param value The value to be retrieved
      * \param BYTE_OFFSET The start of the value in the binary stream
      * \param DATA_LENGTH The length of the binary stream to convert into the value
      */
-    template<class T> void retrieve( T& value, const std::size_t BYTE_OFFSET = 0, std::size_t DATA_LENGTH = 0 )
+    template<class T> void retrieve( T& value, const std::size_t BYTE_OFFSET = 0, std::size_t DATA_LENGTH = 0 ) const
+    {
+        if ( DATA_LENGTH == 0 ) DATA_LENGTH = sizeof( value );
+
+        std::memcpy( &value, stream.data() + BYTE_OFFSET, DATA_LENGTH );
+    }
+
+    /*! \brief Store meaningful information as binary data
+     *
+     * This template method is the inverse of SPE::Data::retrieve().
+     * The value is converted back into binary data and stored internally, ready to be written to an SPE file.
+     * The byte offset and length of data are specified as for SPE::Data::retrieve().
+     *
+     * \param value The value to be stored
+     * \param BYTE_OFFSET The start of the value in the binary stream
+     * \param DATA_LENGTH The length of the binary stream to convert the value into
+     */
+    template<class T> void store( const T& value, const std::size_t BYTE_OFFSET = 0, std::size_t DATA_LENGTH = 0 )
     {
         if ( DATA_LENGTH == 0 ) DATA_LENGTH = sizeof( value );
 
-        const std::string slice( stream.begin() + BYTE_OFFSET, stream.begin() + BYTE_OFFSET + DATA_LENGTH );
-        std::stringstream( slice ).read( reinterpret_cast<char*>( &value ), DATA_LENGTH );
+        std::memcpy( stream.data() + BYTE_OFFSET, &value, DATA_LENGTH );
     }
 
+    /*! \brief Store an array of values as binary data
+     *
+     * The elements of the array are stored one after another.
+     * If the array is shorter than the length of data, the remaining bytes are set to zero.
+     */
+    template<class T> void store( const std::vector<T>& value, const std::size_t BYTE_OFFSET, const std::size_t DATA_LENGTH )
+    {
+        const auto VALUE_LENGTH = std::min( DATA_LENGTH, value.size() * sizeof( T ) );
+
+        std::memcpy( stream.data() + BYTE_OFFSET, value.data(), VALUE_LENGTH );
+        std::fill( stream.begin() + BYTE_OFFSET + VALUE_LENGTH, stream.begin() + BYTE_OFFSET + DATA_LENGTH, 0 );
+    }
+
+    /*! \brief Store a string as binary data
+     *
+     * The string is truncated to the length of data if needed.
+     * If the string is shorter than the length of data, the remaining bytes are set to zero.
+     */
+    void store( const std::string&, const std::size_t, const std::size_t );
+
+    /*! \brief Write data to an SPE file
+     *
+     * This method writes the stored binary data to an SPE file opened for writing.
+     * The data is written at the same offset it would be read from.
+     */
+    virtual void write( std::ostream& );
+
+    /*! \brief Write data to an SPE file opened as a file descriptor
+     *
+     * This method writes the stored binary data using a single positioned write at the same offset it would be read from.
+     * The file position of the descriptor is neither used nor changed.
+     */
+    virtual void write( const int );
+
+    /*! \brief Write data into another instance of data
+     *
+     * This method is the inverse of reading from another instance of data.
+     * The stored binary data is copied into the other instance, which must span the bytes of this instance.
+     */
+    virtual void write( Data& );
+
     private:
     const std::size_t FILE_OFFSET;
     const std::size_t DATA_LENGTH;
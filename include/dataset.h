@@ -0,0 +1,132 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_DATASET_H
+#define SPE_DATASET_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+#include "spe.h"
+#include "reduction.h"
+
+namespace SPE {
+/*! \brief A set of SPE files read as one
+ *
+ * This class opens several SPE files that share the same frame geometry and datatype, such as the files of one experiment, and presents their frames under one global index.
+ * Frames are numbered across the files in the order the files are given, so the first frame of the second file follows the last frame of the first file.
+ * Frames can be read and reduced just like with SPE::File; reductions work on all files in parallel.
+ * A dataset can be read from several threads at once under the same conditions as SPE::File.
+ */
+class Dataset
+{
+    public:
+    /*! \brief Open a list of SPE files as one dataset
+     *
+     * The files are opened in parallel and checked to have the same number of rows and columns and the same datatype.
+     * The optional number of threads defaults to 0 and uses one thread per core.
+     * Optionally, the metadata can be loaded lazily, just like with SPE::File.
+     */
+    Dataset( const std::vector<std::string>&, const unsigned = 0, const bool = false );
+
+    Dataset( const Dataset& ) = delete;
+    Dataset& operator=( const Dataset& ) = delete;
+    ~Dataset() = default;
+
+    /*! \brief Find all SPE files in a directory
+     *
+     * Returns the paths of all files in the directory with an extension .spe, in any case, in alphabetical order.
+     * Pass them to the constructor to open all SPE files in a directory as one dataset.
+     */
+    static std::vector<std::string> findFiles( const std::string& );
+
+    //! \brief Get the number of files in the dataset
+    std::size_t files() const;
+
+    /*! \brief Access one file of the dataset
+     *
+     * This gives access to the metadata and all methods of each individual file.
+     */
+    File& file( const std::size_t );
+
+    /*! \brief Find the file holding a frame of the dataset
+     *
+     * Returns the index of the file and the index of the frame within that file for a global frame index.
+     */
+    std::pair<std::size_t, long> locate( const std::size_t ) const;
+
+    /*! \brief Get intensity of a specified pixel
+     *
+     * The frame is given by its global index across all files.
+     */
+    float getPixel( const unsigned short, const unsigned short, const std::size_t = 0 );
+
+    /*! \brief Get one frame of data
+     *
+     * The frame is given by its global index across all files and is fetched just like with SPE::File::getFrame().
+     */
+    Eigen::ArrayXXf getFrame( const std::size_t = 0 );
+
+    /*! \brief Get several frames of data as one contiguous stack
+     *
+     * Fetches count frames, starting at global frame first and stepping by stride frames, just like SPE::File::getFrames().
+     * The frames may span several files.
+     */
+    FrameStack getFrames( const std::size_t, const std::size_t, const std::size_t = 1 );
+
+    /*! \brief Get the average of all frames in the dataset
+     *
+     * Frames are summed in double precision in blocks of consecutive frames of one file, spread over the threads given when the dataset was opened.
+     * The block sums are always added up in the same order, so the result does not depend on the number of threads.
+     */
+    Eigen::ArrayXXf getAverageFrame();
+
+    /*! \brief Get per-pixel statistics across all frames in the dataset
+     *
+     * This is the counterpart of SPE::File::getStatistics() for all frames of all files.
+     * The frame is split into tiles of pixels that are processed in parallel; each tile is read from every frame of every file in turn, in the datatype of the files.
+     * The optional memory budget, in bytes, limits the working memory of all threads together.
+     * The result does not depend on the number of threads or the memory budget.
+     */
+    Statistics getStatistics( const unsigned = Statistics::ALL, const std::size_t = 256 << 20 );
+
+    //! \brief Get the number of rows in each frame
+    std::size_t rows() const;
+
+    //! \brief Get the number of columns in each frame
+    std::size_t columns() const;
+
+    //! \brief Get the number of frames in all files together
+    std::size_t frames() const;
+
+    private:
+    std::vector<std::unique_ptr<File>> m_files;
+    std::vector<std::size_t> firstFrames;
+    unsigned threads;
+
+    void open( const std::vector<std::string>&, const bool );
+
+    template<class T> PixelReader<T> pixelReader() const;
+    template<class T> Eigen::ArrayXXf getAverageFrameArray() const;
+    template<class T> Statistics getStatisticsArrays( const unsigned, const std::size_t ) const;
+};
+}
+
+#endif
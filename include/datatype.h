@@ -0,0 +1,74 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_DATATYPE_H
+#define SPE_DATATYPE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SPE {
+/*! \brief Datatype of pixel intensities
+ *
+ * This template maps a C++ type to the value of SPE::Metadata::datatype() that denotes it in an SPE file.
+ * Only the four types allowed by the specification are defined.
+ */
+template<class T> struct Datatype;
+
+template<> struct Datatype<float>
+{
+    static const std::int16_t VALUE = 0;
+};
+
+template<> struct Datatype<std::int32_t>
+{
+    static const std::int16_t VALUE = 1;
+};
+
+template<> struct Datatype<std::int16_t>
+{
+    static const std::int16_t VALUE = 2;
+};
+
+template<> struct Datatype<std::uint16_t>
+{
+    static const std::int16_t VALUE = 3;
+};
+
+/*! \brief Get the size of one pixel
+ *
+ * The size in bytes of the intensity of one pixel stored with the given datatype.
+ * Unknown datatypes have a size of zero.
+ */
+inline std::size_t pixelSize( const std::int16_t datatype )
+{
+    switch ( datatype ) {
+        case Datatype<float>::VALUE:
+            return sizeof( float );
+        case Datatype<std::int32_t>::VALUE:
+            return sizeof( std::int32_t );
+        case Datatype<std::int16_t>::VALUE:
+            return sizeof( std::int16_t );
+        case Datatype<std::uint16_t>::VALUE:
+            return sizeof( std::uint16_t );
+        default:
+            return 0;
+    }
+}
+}
+
+#endif
@@ -0,0 +1,116 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_EXPORTER_H
+#define SPE_EXPORTER_H
+
+#include <cstddef>
+#include <string>
+#include <Eigen/Core>
+
+#include "frameStack.h"
+
+namespace SPE {
+class File;
+
+/*! \brief Export frames to binary files
+ *
+ * This class writes frames of floating point values to a file, one frame after the other, as they are handed to it.
+ * Frames are written as 32-bit little-endian floating point values, each frame row after row, so the file holds a three-dimensional array of frames x rows x columns in C order.
+ * A NumPy .npy file starts with a header describing the array, so it can be loaded or memory mapped with numpy.load(); a raw file holds only the values.
+ * Large numbers of frames can be streamed to the file without holding them all in memory.
+ * The number of frames in the .npy header is updated when the exporter is closed.
+ */
+class Exporter
+{
+    public:
+    //! \brief The supported file formats
+    enum Format {
+        NPY,
+        RAW
+    };
+
+    /*! \brief Create a file for frames of the given size
+     *
+     * An existing file at the path is overwritten.
+     */
+    Exporter( const std::string&, const std::size_t, const std::size_t, const Format = NPY );
+    Exporter( const Exporter& ) = delete;
+    Exporter& operator=( const Exporter& ) = delete;
+
+    /*! \brief Close the file
+     *
+     * Errors while closing are ignored here; call SPE::Exporter::close() to see them.
+     */
+    ~Exporter();
+
+    /*! \brief Append one frame
+     *
+     * The frame must have the size given when the exporter was created.
+     */
+    void write( const Eigen::Ref<const Eigen::ArrayXXf>& );
+
+    /*! \brief Append a stack of frames
+     *
+     * The values of the stack are written in one go, without a copy.
+     */
+    void write( const FrameStack& );
+
+    /*! \brief Append frames read from an SPE file
+     *
+     * Fetches count frames, starting at frame first, a few at a time and appends them, so the frames are never all in memory at once.
+     */
+    void write( File&, const long, const long );
+
+    /*! \brief Complete and close the file
+     *
+     * The final number of frames is written into the header of an .npy file.
+     */
+    void close();
+
+    //! \brief Get the number of frames written so far
+    std::size_t frames() const;
+
+    /*! \brief Save one frame to a file
+     *
+     * The frame is saved as a two-dimensional array of rows x columns.
+     */
+    static void save( const std::string&, const Eigen::Ref<const Eigen::ArrayXXf>&, const Format = NPY );
+
+    /*! \brief Save a stack of frames to a file
+     *
+     * The stack is saved as a three-dimensional array of frames x rows x columns.
+     */
+    static void save( const std::string&, const FrameStack&, const Format = NPY );
+
+    private:
+    std::string path;
+    std::size_t m_rows;
+    std::size_t m_columns;
+    Format format;
+    int fileDescriptor = -1;
+    std::size_t m_frames = 0;
+    bool stack = true;
+
+    Exporter( const std::string&, const std::size_t, const std::size_t, const Format, const bool );
+
+    void append( const char*, std::size_t );
+    std::string header() const;
+};
+}
+
+#endif
@@ -0,0 +1,401 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_FIELDS_H
+#define SPE_FIELDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "metadata.h"
+#include "offsets.h"
+
+namespace SPE {
+/*! \brief Descriptors of the fields in an SPE file header
+ *
+ * Each descriptor is named after the metadata field it describes and records the type, location and length of the field in the header.
+ * Together, the descriptors form SPE::Field::Header, a table of all fields in the order they appear in the header.
+ * Decoding, encoding and printing of metadata are all generated from this table at compile time, so a new field only needs to be added here.
+ */
+namespace Field {
+/*! \brief Type and location of a field in the header
+ *
+ * All field descriptors derive from this template.
+ * The offset is counted in bytes from the start of the file and the length defaults to the size of the field type.
+ * Fields are printed in decimal unless the descriptor sets HEXADECIMAL.
+ */
+template<class T, T Metadata::* MEMBER, std::size_t FIELD_OFFSET, std::size_t FIELD_LENGTH = sizeof( T )> struct Descriptor
+{
+    typedef T value_type;
+    static const std::size_t OFFSET = FIELD_OFFSET;
+    static const std::size_t LENGTH = FIELD_LENGTH;
+    static const bool HEXADECIMAL = false;
+
+    static value_type& member( Metadata& metadata )
+    {
+        return metadata.*MEMBER;
+    }
+
+    static const value_type& member( const Metadata& metadata )
+    {
+        return metadata.*MEMBER;
+    }
+};
+
+/*! \brief A list of field descriptors
+ *
+ * The list is traversed at compile time.
+ * Visiting the list calls visitor.visit<FIELD>() once for each field, in order, so each call can be inlined with the field's type, offset and length known.
+ */
+template<class... FIELDS> struct FieldList
+{
+    template<class VISITOR> static void visit( VISITOR& visitor )
+    {
+        const int expand[] = { 0, ( visitor.template visit<FIELDS>(), 0 )... };
+        static_cast<void>( expand );
+    }
+
+    /*! \brief Check the layout of the fields
+     *
+     * A layout is valid if the fields are listed in increasing order of offset, do not overlap and all fit within the header.
+     */
+    static constexpr bool isValid()
+    {
+        return Layout<FIELDS...>::isValid( 0 );
+    }
+
+    private:
+    template<class... REST> struct Layout
+    {
+        static constexpr bool isValid( const std::size_t END )
+        {
+            return END <= OFFSET_DATA;
+        }
+    };
+
+    template<class FIELD, class... REST> struct Layout<FIELD, REST...>
+    {
+        static constexpr bool isValid( const std::size_t END )
+        {
+            return FIELD::OFFSET >= END and Layout<REST...>::isValid( FIELD::OFFSET + FIELD::LENGTH );
+        }
+    };
+};
+
+struct ControllerVersion : Descriptor<std::int16_t, &Metadata::ControllerVersion, OFFSET_CONTROLLERVERSION> { static const char* name() { return "ControllerVersion"; } };
+struct LogicOutput : Descriptor<std::int16_t, &Metadata::LogicOutput, OFFSET_LOGICOUTPUT> { static const char* name() { return "LogicOutput"; } };
+struct AmpHiCapLowNoise : Descriptor<std::uint16_t, &Metadata::AmpHiCapLowNoise, OFFSET_AMPHICAPLOWNOISE> { static const char* name() { return "AmpHiCapLowNoise"; } };
+struct xDimDet : Descriptor<std::uint16_t, &Metadata::xDimDet, OFFSET_XDIMDET> { static const char* name() { return "xDimDet"; } };
+struct mode : Descriptor<std::int16_t, &Metadata::mode, OFFSET_MODE> { static const char* name() { return "mode"; } };
+struct exp_sec : Descriptor<float, &Metadata::exp_sec, OFFSET_EXP_SEC> { static const char* name() { return "exp_sec"; } };
+struct VChipXdim : Descriptor<std::int16_t, &Metadata::VChipXdim, OFFSET_VCHIPXDIM> { static const char* name() { return "VChipXdim"; } };
+struct VChipYdim : Descriptor<std::int16_t, &Metadata::VChipYdim, OFFSET_VCHIPYDIM> { static const char* name() { return "VChipYdim"; } };
+struct yDimDet : Descriptor<std::uint16_t, &Metadata::yDimDet, OFFSET_YDIMDET> { static const char* name() { return "yDimDet"; } };
+struct date : Descriptor<std::string, &Metadata::date, OFFSET_DATE, DATEMAX> { static const char* name() { return "date"; } };
+struct VirtualChipFlag : Descriptor<std::int16_t, &Metadata::VirtualChipFlag, OFFSET_VIRTUALCHIPFLAG> { static const char* name() { return "VirtualChipFlag"; } };
+struct noscan : Descriptor<std::int16_t, &Metadata::noscan, OFFSET_NOSCAN> { static const char* name() { return "noscan"; } };
+struct DetTemperature : Descriptor<float, &Metadata::DetTemperature, OFFSET_DETTEMPERATURE> { static const char* name() { return "DetTemperature"; } };
+struct DetType : Descriptor<std::int16_t, &Metadata::DetType, OFFSET_DETTYPE> { static const char* name() { return "DetType"; } };
+struct xdim : Descriptor<std::uint16_t, &Metadata::m_xdim, OFFSET_XDIM> { static const char* name() { return "xdim"; } };
+struct stdiode : Descriptor<std::int16_t, &Metadata::stdiode, OFFSET_STDIODE> { static const char* name() { return "stdiode"; } };
+struct DelayTime : Descriptor<float, &Metadata::DelayTime, OFFSET_DELAYTIME> { static const char* name() { return "DelayTime"; } };
+struct ShutterControl : Descriptor<std::uint16_t, &Metadata::ShutterControl, OFFSET_SHUTTERCONTROL> { static const char* name() { return "ShutterControl"; } };
+struct AbsorbLive : Descriptor<std::int16_t, &Metadata::AbsorbLive, OFFSET_ABSORBLIVE> { static const char* name() { return "AbsorbLive"; } };
+struct AbsorbMode : Descriptor<std::uint16_t, &Metadata::AbsorbMode, OFFSET_ABSORBMODE> { static const char* name() { return "AbsorbMode"; } };
+struct CanDoVirtualChipFlag : Descriptor<std::int16_t, &Metadata::CanDoVirtualChipFlag, OFFSET_CANDOVIRTUALCHIPFLAG> { static const char* name() { return "CanDoVirtualChipFlag"; } };
+struct ThresholdMinLive : Descriptor<std::int16_t, &Metadata::ThresholdMinLive, OFFSET_THRESHOLDMINLIVE> { static const char* name() { return "ThresholdMinLive"; } };
+struct ThresholdMinVal : Descriptor<float, &Metadata::ThresholdMinVal, OFFSET_THRESHOLDMINVAL> { static const char* name() { return "ThresholdMinVal"; } };
+struct ThresholdMaxLive : Descriptor<std::int16_t, &Metadata::ThresholdMaxLive, OFFSET_THRESHOLDMAXLIVE> { static const char* name() { return "ThresholdMaxLive"; } };
+struct ThresholdMaxVal : Descriptor<float, &Metadata::ThresholdMaxVal, OFFSET_THRESHOLDMAXVAL> { static const char* name() { return "ThresholdMaxVal"; } };
+struct SpecAutoSpectroMode : Descriptor<std::int16_t, &Metadata::SpecAutoSpectroMode, OFFSET_SPECAUTOSPECTROMODE> { static const char* name() { return "SpecAutoSpectroMode"; } };
+struct SpecCenterWlNm : Descriptor<float, &Metadata::SpecCenterWlNm, OFFSET_SPECCENTERWLNM> { static const char* name() { return "SpecCenterWlNm"; } };
+struct SpecGlueFlag : Descriptor<std::int16_t, &Metadata::SpecGlueFlag, OFFSET_SPECGLUEFLAG> { static const char* name() { return "SpecGlueFlag"; } };
+struct SpecGlueStartWlNm : Descriptor<float, &Metadata::SpecGlueStartWlNm, OFFSET_SPECGLUESTARTWLNM> { static const char* name() { return "SpecGlueStartWlNm"; } };
+struct SpecGlueEndWlNm : Descriptor<float, &Metadata::SpecGlueEndWlNm, OFFSET_SPECGLUEENDWLNM> { static const char* name() { return "SpecGlueEndWlNm"; } };
+struct SpecGlueMinOvrlpNm : Descriptor<float, &Metadata::SpecGlueMinOvrlpNm, OFFSET_SPECGLUEMINOVRLPNM> { static const char* name() { return "SpecGlueMinOvrlpNm"; } };
+struct SpecGlueFinalResNm : Descriptor<float, &Metadata::SpecGlueFinalResNm, OFFSET_SPECGLUEFINALRESNM> { static const char* name() { return "SpecGlueFinalResNm"; } };
+struct PulserType : Descriptor<std::int16_t, &Metadata::PulserType, OFFSET_PULSERTYPE> { static const char* name() { return "PulserType"; } };
+struct CustomChipFlag : Descriptor<std::int16_t, &Metadata::CustomChipFlag, OFFSET_CUSTOMCHIPFLAG> { static const char* name() { return "CustomChipFlag"; } };
+struct XPrePixels : Descriptor<std::int16_t, &Metadata::XPrePixels, OFFSET_XPREPIXELS> { static const char* name() { return "XPrePixels"; } };
+struct XPostPixels : Descriptor<std::int16_t, &Metadata::XPostPixels, OFFSET_XPOSTPIXELS> { static const char* name() { return "XPostPixels"; } };
+struct YPrePixels : Descriptor<std::int16_t, &Metadata::YPrePixels, OFFSET_YPREPIXELS> { static const char* name() { return "YPrePixels"; } };
+struct YPostPixels : Descriptor<std::int16_t, &Metadata::YPostPixels, OFFSET_YPOSTPIXELS> { static const char* name() { return "YPostPixels"; } };
+struct asynen : Descriptor<std::int16_t, &Metadata::asynen, OFFSET_ASYNEN> { static const char* name() { return "asynen"; } };
+struct datatype : Descriptor<std::int16_t, &Metadata::m_datatype, OFFSET_DATATYPE> { static const char* name() { return "datatype"; } };
+struct PulserMode : Descriptor<std::int16_t, &Metadata::PulserMode, OFFSET_PULSERMODE> { static const char* name() { return "PulserMode"; } };
+struct PulserOnChipAccums : Descriptor<std::uint16_t, &Metadata::PulserOnChipAccums, OFFSET_PULSERONCHIPACCUMS> { static const char* name() { return "PulserOnChipAccums"; } };
+struct PulserRepeatExp : Descriptor<std::int32_t, &Metadata::PulserRepeatExp, OFFSET_PULSERREPEATEXP> { static const char* name() { return "PulserRepeatExp"; } };
+struct PulseRepWidth : Descriptor<float, &Metadata::PulseRepWidth, OFFSET_PULSEREPWIDTH> { static const char* name() { return "PulseRepWidth"; } };
+struct PulseRepDelay : Descriptor<float, &Metadata::PulseRepDelay, OFFSET_PULSEREPDELAY> { static const char* name() { return "PulseRepDelay"; } };
+struct PulseSeqStartWidth : Descriptor<float, &Metadata::PulseSeqStartWidth, OFFSET_PULSESEQSTARTWIDTH> { static const char* name() { return "PulseSeqStartWidth"; } };
+struct PulseSeqEndWidth : Descriptor<float, &Metadata::PulseSeqEndWidth, OFFSET_PULSESEQENDWIDTH> { static const char* name() { return "PulseSeqEndWidth"; } };
+struct PulseSeqStartDelay : Descriptor<float, &Metadata::PulseSeqStartDelay, OFFSET_PULSESEQSTARTDELAY> { static const char* name() { return "PulseSeqStartDelay"; } };
+struct PulseSeqEndDelay : Descriptor<float, &Metadata::PulseSeqEndDelay, OFFSET_PULSESEQENDDELAY> { static const char* name() { return "PulseSeqEndDelay"; } };
+struct PulseSeqIncMode : Descriptor<std::int16_t, &Metadata::PulseSeqIncMode, OFFSET_PULSESEQINCMODE> { static const char* name() { return "PulseSeqIncMode"; } };
+struct PImaxUsed : Descriptor<std::int16_t, &Metadata::PImaxUsed, OFFSET_PIMAXUSED> { static const char* name() { return "PImaxUsed"; } };
+struct PImaxMode : Descriptor<std::int16_t, &Metadata::PImaxMode, OFFSET_PIMAXMODE> { static const char* name() { return "PImaxMode"; } };
+struct PImaxGain : Descriptor<std::int16_t, &Metadata::PImaxGain, OFFSET_PIMAXGAIN> { static const char* name() { return "PImaxGain"; } };
+struct BackGrndApplied : Descriptor<std::int16_t, &Metadata::BackGrndApplied, OFFSET_BACKGRNDAPPLIED> { static const char* name() { return "BackGrndApplied"; } };
+struct PImax2nsBrdUsed : Descriptor<std::int16_t, &Metadata::PImax2nsBrdUsed, OFFSET_PIMAX2NSBRDUSED> { static const char* name() { return "PImax2nsBrdUsed"; } };
+struct minblk : Descriptor<std::uint16_t, &Metadata::minblk, OFFSET_MINBLK> { static const char* name() { return "minblk"; } };
+struct numminblk : Descriptor<std::uint16_t, &Metadata::numminblk, OFFSET_NUMMINBLK> { static const char* name() { return "numminblk"; } };
+struct SpecMirrorLocation : Descriptor<std::vector<std::int16_t>, &Metadata::SpecMirrorLocation, OFFSET_SPECMIRRORLOCATION, 4> { static const char* name() { return "SpecMirrorLocation"; } };
+struct SpecSlitLocation : Descriptor<std::vector<std::int16_t>, &Metadata::SpecSlitLocation, OFFSET_SPECSLITLOCATION, 8> { static const char* name() { return "SpecSlitLocation"; } };
+struct CustomTimingFlag : Descriptor<std::int16_t, &Metadata::CustomTimingFlag, OFFSET_CUSTOMTIMINGFLAG> { static const char* name() { return "CustomTimingFlag"; } };
+struct ExperimentTimeLocal : Descriptor<std::string, &Metadata::ExperimentTimeLocal, OFFSET_EXPERIMENTTIMELOCAL, TIMEMAX> { static const char* name() { return "ExperimentTimeLocal"; } };
+struct ExperimentTimeUTC : Descriptor<std::string, &Metadata::ExperimentTimeUTC, OFFSET_EXPERIMENTTIMEUTC, TIMEMAX> { static const char* name() { return "ExperimentTimeUTC"; } };
+struct ExposUnits : Descriptor<std::int16_t, &Metadata::ExposUnits, OFFSET_EXPOSUNITS> { static const char* name() { return "ExposUnits"; } };
+struct ADCoffset : Descriptor<std::uint16_t, &Metadata::ADCoffset, OFFSET_ADCOFFSET> { static const char* name() { return "ADCoffset"; } };
+struct ADCrate : Descriptor<std::uint16_t, &Metadata::ADCrate, OFFSET_ADCRATE> { static const char* name() { return "ADCrate"; } };
+struct ADCtype : Descriptor<std::uint16_t, &Metadata::ADCtype, OFFSET_ADCTYPE> { static const char* name() { return "ADCtype"; } };
+struct ADCresolution : Descriptor<std::uint16_t, &Metadata::ADCresolution, OFFSET_ADCRESOLUTION> { static const char* name() { return "ADCresolution"; } };
+struct ADCbitAdjust : Descriptor<std::uint16_t, &Metadata::ADCbitAdjust, OFFSET_ADCBITADJUST> { static const char* name() { return "ADCbitAdjust"; } };
+struct gain : Descriptor<std::uint16_t, &Metadata::gain, OFFSET_GAIN> { static const char* name() { return "gain"; } };
+struct Comments : Descriptor<std::vector<std::string>, &Metadata::Comments, OFFSET_COMMENTS, 5 * COMMENTMAX> { static const char* name() { return "Comments"; } };
+struct geometric : Descriptor<std::uint16_t, &Metadata::geometric, OFFSET_GEOMETRIC> { static const char* name() { return "geometric"; } };
+struct xlabel : Descriptor<std::string, &Metadata::xlabel, OFFSET_XLABEL, LABELMAX> { static const char* name() { return "xlabel"; } };
+struct cleans : Descriptor<std::uint16_t, &Metadata::cleans, OFFSET_CLEANS> { static const char* name() { return "cleans"; } };
+struct NumSkpPerCln : Descriptor<std::uint16_t, &Metadata::NumSkpPerCln, OFFSET_NUMSKPPERCLN> { static const char* name() { return "NumSkpPerCln"; } };
+struct SpecMirrorPos : Descriptor<std::vector<std::int16_t>, &Metadata::SpecMirrorPos, OFFSET_SPECMIRRORPOS, 4> { static const char* name() { return "SpecMirrorPos"; } };
+struct SpecSlitPos : Descriptor<std::vector<float>, &Metadata::SpecSlitPos, OFFSET_SPECSLITPOS, 16> { static const char* name() { return "SpecSlitPos"; } };
+struct AutoCleansActive : Descriptor<std::int16_t, &Metadata::AutoCleansActive, OFFSET_AUTOCLEANSACTIVE> { static const char* name() { return "AutoCleansActive"; } };
+struct UseContCleansInst : Descriptor<std::int16_t, &Metadata::UseContCleansInst, OFFSET_USECONTCLEANSINST> { static const char* name() { return "UseContCleansInst"; } };
+struct AbsorbStripNum : Descriptor<std::int16_t, &Metadata::AbsorbStripNum, OFFSET_ABSORBSTRIPNUM> { static const char* name() { return "AbsorbStripNum"; } };
+struct SpecSlitPosUnits : Descriptor<std::int16_t, &Metadata::SpecSlitPosUnits, OFFSET_SPECSLITPOSUNITS> { static const char* name() { return "SpecSlitPosUnits"; } };
+struct SpecGrooves : Descriptor<float, &Metadata::SpecGrooves, OFFSET_SPECGROOVES> { static const char* name() { return "SpecGrooves"; } };
+struct srccmp : Descriptor<std::int16_t, &Metadata::srccmp, OFFSET_SRCCMP> { static const char* name() { return "srccmp"; } };
+struct ydim : Descriptor<std::uint16_t, &Metadata::m_ydim, OFFSET_YDIM> { static const char* name() { return "ydim"; } };
+struct scramble : Descriptor<std::int16_t, &Metadata::scramble, OFFSET_SCRAMBLE> { static const char* name() { return "scramble"; } };
+struct ContinuousCleansFlag : Descriptor<std::int16_t, &Metadata::ContinuousCleansFlag, OFFSET_CONTINUOUSCLEANSFLAG> { static const char* name() { return "ContinuousCleansFlag"; } };
+struct ExternalTriggerFlag : Descriptor<std::int16_t, &Metadata::ExternalTriggerFlag, OFFSET_EXTERNALTRIGGERFLAG> { static const char* name() { return "ExternalTriggerFlag"; } };
+struct lnoscan : Descriptor<std::int32_t, &Metadata::lnoscan, OFFSET_LNOSCAN> { static const char* name() { return "lnoscan"; } };
+struct lavgexp : Descriptor<std::int32_t, &Metadata::lavgexp, OFFSET_LAVGEXP> { static const char* name() { return "lavgexp"; } };
+struct ReadoutTime : Descriptor<float, &Metadata::ReadoutTime, OFFSET_READOUTTIME> { static const char* name() { return "ReadoutTime"; } };
+struct TriggeredModeFlag : Descriptor<std::int16_t, &Metadata::TriggeredModeFlag, OFFSET_TRIGGEREDMODEFLAG> { static const char* name() { return "TriggeredModeFlag"; } };
+struct sw_version : Descriptor<std::string, &Metadata::sw_version, OFFSET_SW_VERSION, FILEVERMAX> { static const char* name() { return "sw_version"; } };
+struct type : Descriptor<std::int16_t, &Metadata::type, OFFSET_TYPE> { static const char* name() { return "type"; } };
+struct flatFieldApplied : Descriptor<std::int16_t, &Metadata::flatFieldApplied, OFFSET_FLATFIELDAPPLIED> { static const char* name() { return "flatFieldApplied"; } };
+struct kin_trig_mode : Descriptor<std::int16_t, &Metadata::kin_trig_mode, OFFSET_KIN_TRIG_MODE> { static const char* name() { return "kin_trig_mode"; } };
+struct dlabel : Descriptor<std::string, &Metadata::dlabel, OFFSET_DLABEL, LABELMAX> { static const char* name() { return "dlabel"; } };
+struct PulseFileName : Descriptor<std::string, &Metadata::PulseFileName, OFFSET_PULSEFILENAME, HDRNAMEMAX> { static const char* name() { return "PulseFileName"; } };
+struct AbsorbFileName : Descriptor<std::string, &Metadata::AbsorbFileName, OFFSET_ABSORBFILENAME, HDRNAMEMAX> { static const char* name() { return "AbsorbFileName"; } };
+struct NumExpRepeats : Descriptor<std::int32_t, &Metadata::NumExpRepeats, OFFSET_NUMEXPREPEATS> { static const char* name() { return "NumExpRepeats"; } };
+struct NumExpAccums : Descriptor<std::int32_t, &Metadata::NumExpAccums, OFFSET_NUMEXPACCUMS> { static const char* name() { return "NumExpAccums"; } };
+struct YT_Flag : Descriptor<std::int16_t, &Metadata::YT_Flag, OFFSET_YT_FLAG> { static const char* name() { return "YT_Flag"; } };
+struct clkspd_us : Descriptor<float, &Metadata::clkspd_us, OFFSET_CLKSPD_US> { static const char* name() { return "clkspd_us"; } };
+struct HWaccumFlag : Descriptor<std::int16_t, &Metadata::HWaccumFlag, OFFSET_HWACCUMFLAG> { static const char* name() { return "HWaccumFlag"; } };
+struct StoreSync : Descriptor<std::int16_t, &Metadata::StoreSync, OFFSET_STORESYNC> { static const char* name() { return "StoreSync"; } };
+struct BlemishApplied : Descriptor<std::int16_t, &Metadata::BlemishApplied, OFFSET_BLEMISHAPPLIED> { static const char* name() { return "BlemishApplied"; } };
+struct CosmicApplied : Descriptor<std::int16_t, &Metadata::CosmicApplied, OFFSET_COSMICAPPLIED> { static const char* name() { return "CosmicApplied"; } };
+struct CosmicType : Descriptor<std::int16_t, &Metadata::CosmicType, OFFSET_COSMICTYPE> { static const char* name() { return "CosmicType"; } };
+struct CosmicThreshold : Descriptor<float, &Metadata::CosmicThreshold, OFFSET_COSMICTHRESHOLD> { static const char* name() { return "CosmicThreshold"; } };
+struct NumFrames : Descriptor<std::int32_t, &Metadata::m_NumFrames, OFFSET_NUMFRAMES> { static const char* name() { return "NumFrames"; } };
+struct MaxIntensity : Descriptor<float, &Metadata::MaxIntensity, OFFSET_MAXINTENSITY> { static const char* name() { return "MaxIntensity"; } };
+struct MinIntensity : Descriptor<float, &Metadata::MinIntensity, OFFSET_MININTENSITY> { static const char* name() { return "MinIntensity"; } };
+struct ylabel : Descriptor<std::string, &Metadata::ylabel, OFFSET_YLABEL, LABELMAX> { static const char* name() { return "ylabel"; } };
+struct ShutterType : Descriptor<std::uint16_t, &Metadata::ShutterType, OFFSET_SHUTTERTYPE> { static const char* name() { return "ShutterType"; } };
+struct shutterComp : Descriptor<float, &Metadata::shutterComp, OFFSET_SHUTTERCOMP> { static const char* name() { return "shutterComp"; } };
+struct readoutMode : Descriptor<std::uint16_t, &Metadata::readoutMode, OFFSET_READOUTMODE> { static const char* name() { return "readoutMode"; } };
+struct WindowSize : Descriptor<std::uint16_t, &Metadata::WindowSize, OFFSET_WINDOWSIZE> { static const char* name() { return "WindowSize"; } };
+struct clkspd : Descriptor<std::uint16_t, &Metadata::clkspd, OFFSET_CLKSPD> { static const char* name() { return "clkspd"; } };
+struct interface_type : Descriptor<std::uint16_t, &Metadata::interface_type, OFFSET_INTERFACE_TYPE> { static const char* name() { return "interface_type"; } };
+struct NumROIsInExperiment : Descriptor<std::int16_t, &Metadata::NumROIsInExperiment, OFFSET_NUMROISINEXPERIMENT> { static const char* name() { return "NumROIsInExperiment"; } };
+struct controllerNum : Descriptor<std::uint16_t, &Metadata::controllerNum, OFFSET_CONTROLLERNUM> { static const char* name() { return "controllerNum"; } };
+struct SWmade : Descriptor<std::uint16_t, &Metadata::SWmade, OFFSET_SWMADE> { static const char* name() { return "SWmade"; } };
+struct NumROI : Descriptor<std::int16_t, &Metadata::NumROI, OFFSET_NUMROI> { static const char* name() { return "NumROI"; } };
+struct ROIinfoblk : Descriptor<std::vector<ROIData>, &Metadata::ROIinfoblk, OFFSET_ROIINFOBLK_0, ROIMAX * 12> { static const char* name() { return "ROIinfoblk"; } };
+struct FlatField : Descriptor<std::string, &Metadata::FlatField, OFFSET_FLATFIELD, HDRNAMEMAX> { static const char* name() { return "FlatField"; } };
+struct background : Descriptor<std::string, &Metadata::background, OFFSET_BACKGROUND, HDRNAMEMAX> { static const char* name() { return "background"; } };
+struct blemish : Descriptor<std::string, &Metadata::blemish, OFFSET_BLEMISH, HDRNAMEMAX> { static const char* name() { return "blemish"; } };
+struct file_header_ver : Descriptor<float, &Metadata::file_header_ver, OFFSET_FILE_HEADER_VER> { static const char* name() { return "file_header_ver"; } };
+struct YT_Info : Descriptor<std::string, &Metadata::YT_Info, OFFSET_YT_INFO, 1000> { static const char* name() { return "YT_Info"; } };
+struct WinView_id : Descriptor<std::int32_t, &Metadata::WinView_id, OFFSET_WINVIEW_ID> { static const char* name() { return "WinView_id"; } static const bool HEXADECIMAL = true; };
+struct xcalibration : Descriptor<CalibrationData, &Metadata::xcalibration, OFFSET_XCALIBRATION, 489> { static const char* name() { return "xcalibration"; } };
+struct ycalibration : Descriptor<CalibrationData, &Metadata::ycalibration, OFFSET_YCALIBRATION, 489> { static const char* name() { return "ycalibration"; } };
+struct Istring : Descriptor<std::string, &Metadata::Istring, OFFSET_ISTRING, 40> { static const char* name() { return "Istring"; } };
+struct SpecType : Descriptor<std::uint8_t, &Metadata::SpecType, OFFSET_SPECTYPE> { static const char* name() { return "SpecType"; } };
+struct SpecModel : Descriptor<std::uint8_t, &Metadata::SpecModel, OFFSET_SPECMODEL> { static const char* name() { return "SpecModel"; } };
+struct PulseBurstUsed : Descriptor<std::uint8_t, &Metadata::PulseBurstUsed, OFFSET_PULSEBURSTUSED> { static const char* name() { return "PulseBurstUsed"; } };
+struct PulseBurstCount : Descriptor<std::int32_t, &Metadata::PulseBurstCount, OFFSET_PULSEBURSTCOUNT> { static const char* name() { return "PulseBurstCount"; } };
+struct PulseBurstPeriod : Descriptor<double, &Metadata::PulseBurstPeriod, OFFSET_PULSEBURSTPERIOD> { static const char* name() { return "PulseBurstPeriod"; } };
+struct PulseBracketUsed : Descriptor<std::uint8_t, &Metadata::PulseBracketUsed, OFFSET_PULSEBRACKETUSED> { static const char* name() { return "PulseBracketUsed"; } };
+struct PulseBracketType : Descriptor<std::uint8_t, &Metadata::PulseBracketType, OFFSET_PULSEBRACKETTYPE> { static const char* name() { return "PulseBracketType"; } };
+struct PulseTimeConstFast : Descriptor<double, &Metadata::PulseTimeConstFast, OFFSET_PULSETIMECONSTFAST> { static const char* name() { return "PulseTimeConstFast"; } };
+struct PulseAmplitudeFast : Descriptor<double, &Metadata::PulseAmplitudeFast, OFFSET_PULSEAMPLITUDEFAST> { static const char* name() { return "PulseAmplitudeFast"; } };
+struct PulseTimeConstSlow : Descriptor<double, &Metadata::PulseTimeConstSlow, OFFSET_PULSETIMECONSTSLOW> { static const char* name() { return "PulseTimeConstSlow"; } };
+struct PulseAmplitudeSlow : Descriptor<double, &Metadata::PulseAmplitudeSlow, OFFSET_PULSEAMPLITUDESLOW> { static const char* name() { return "PulseAmplitudeSlow"; } };
+struct AnalogGain : Descriptor<std::int16_t, &Metadata::AnalogGain, OFFSET_ANALOGGAIN> { static const char* name() { return "AnalogGain"; } };
+struct AvGainUsed : Descriptor<std::int16_t, &Metadata::AvGainUsed, OFFSET_AVGAINUSED> { static const char* name() { return "AvGainUsed"; } };
+struct AvGain : Descriptor<std::int16_t, &Metadata::AvGain, OFFSET_AVGAIN> { static const char* name() { return "AvGain"; } };
+struct lastvalue : Descriptor<std::int16_t, &Metadata::lastvalue, OFFSET_LASTVALUE> { static const char* name() { return "lastvalue"; } static const bool HEXADECIMAL = true; };
+
+typedef FieldList<
+    ControllerVersion,
+    LogicOutput,
+    AmpHiCapLowNoise,
+    xDimDet,
+    mode,
+    exp_sec,
+    VChipXdim,
+    VChipYdim,
+    yDimDet,
+    date,
+    VirtualChipFlag,
+    noscan,
+    DetTemperature,
+    DetType,
+    xdim,
+    stdiode,
+    DelayTime,
+    ShutterControl,
+    AbsorbLive,
+    AbsorbMode,
+    CanDoVirtualChipFlag,
+    ThresholdMinLive,
+    ThresholdMinVal,
+    ThresholdMaxLive,
+    ThresholdMaxVal,
+    SpecAutoSpectroMode,
+    SpecCenterWlNm,
+    SpecGlueFlag,
+    SpecGlueStartWlNm,
+    SpecGlueEndWlNm,
+    SpecGlueMinOvrlpNm,
+    SpecGlueFinalResNm,
+    PulserType,
+    CustomChipFlag,
+    XPrePixels,
+    XPostPixels,
+    YPrePixels,
+    YPostPixels,
+    asynen,
+    datatype,
+    PulserMode,
+    PulserOnChipAccums,
+    PulserRepeatExp,
+    PulseRepWidth,
+    PulseRepDelay,
+    PulseSeqStartWidth,
+    PulseSeqEndWidth,
+    PulseSeqStartDelay,
+    PulseSeqEndDelay,
+    PulseSeqIncMode,
+    PImaxUsed,
+    PImaxMode,
+    PImaxGain,
+    BackGrndApplied,
+    PImax2nsBrdUsed,
+    minblk,
+    numminblk,
+    SpecMirrorLocation,
+    SpecSlitLocation,
+    CustomTimingFlag,
+    ExperimentTimeLocal,
+    ExperimentTimeUTC,
+    ExposUnits,
+    ADCoffset,
+    ADCrate,
+    ADCtype,
+    ADCresolution,
+    ADCbitAdjust,
+    gain,
+    Comments,
+    geometric,
+    xlabel,
+    cleans,
+    NumSkpPerCln,
+    SpecMirrorPos,
+    SpecSlitPos,
+    AutoCleansActive,
+    UseContCleansInst,
+    AbsorbStripNum,
+    SpecSlitPosUnits,
+    SpecGrooves,
+    srccmp,
+    ydim,
+    scramble,
+    ContinuousCleansFlag,
+    ExternalTriggerFlag,
+    lnoscan,
+    lavgexp,
+    ReadoutTime,
+    TriggeredModeFlag,
+    sw_version,
+    type,
+    flatFieldApplied,
+    kin_trig_mode,
+    dlabel,
+    PulseFileName,
+    AbsorbFileName,
+    NumExpRepeats,
+    NumExpAccums,
+    YT_Flag,
+    clkspd_us,
+    HWaccumFlag,
+    StoreSync,
+    BlemishApplied,
+    CosmicApplied,
+    CosmicType,
+    CosmicThreshold,
+    NumFrames,
+    MaxIntensity,
+    MinIntensity,
+    ylabel,
+    ShutterType,
+    shutterComp,
+    readoutMode,
+    WindowSize,
+    clkspd,
+    interface_type,
+    NumROIsInExperiment,
+    controllerNum,
+    SWmade,
+    NumROI,
+    ROIinfoblk,
+    FlatField,
+    background,
+    blemish,
+    file_header_ver,
+    YT_Info,
+    WinView_id,
+    xcalibration,
+    ycalibration,
+    Istring,
+    SpecType,
+    SpecModel,
+    PulseBurstUsed,
+    PulseBurstCount,
+    PulseBurstPeriod,
+    PulseBracketUsed,
+    PulseBracketType,
+    PulseTimeConstFast,
+    PulseAmplitudeFast,
+    PulseTimeConstSlow,
+    PulseAmplitudeSlow,
+    AnalogGain,
+    AvGainUsed,
+    AvGain,
+    lastvalue
+> Header;
+
+static_assert( Header::isValid(), "Header fields must be in order, must not overlap and must fit within the header." );
+}
+}
+
+#endif
@@ -0,0 +1,43 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_FRAME_H
+#define SPE_FRAME_H
+
+#include <Eigen/Core>
+
+namespace SPE {
+/*! \brief A read-only view of one frame of data
+ *
+ * The view is laid out row-major, just like the frame is stored in the SPE file, and keeps the datatype used in the file.
+ */
+template<class T> using FrameMap = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
+
+/*! \brief One frame of data stored as type T
+ *
+ * This is the counterpart of Eigen::ArrayXXf for frames kept in the datatype used by the SPE file.
+ */
+template<class T> using FrameArray = Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+/*! \brief One frame of floating point values laid out row-major
+ *
+ * This is the row-major counterpart of Eigen::ArrayXXf, matching the layout of frames in the SPE file.
+ */
+typedef Eigen::Array<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorArrayXXf;
+}
+
+#endif
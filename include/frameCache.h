@@ -0,0 +1,104 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_FRAMECACHE_H
+#define SPE_FRAMECACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <Eigen/Core>
+
+namespace SPE {
+/*! \brief A cache of decoded frames
+ *
+ * This class keeps recently decoded frames of one SPE file in memory, up to a budget of bytes.
+ * When the budget is exceeded, the least recently used frames are evicted first.
+ * Frames are shared, so handing out a cached frame costs no more than copying a reference.
+ * The cache counts hits and misses to help size the budget.
+ * All methods lock the cache, so it can be shared by several threads.
+ */
+class FrameCache
+{
+    public:
+    /*! \brief Create a frame cache
+     *
+     * The optional budget is the most memory, in bytes, the cached frames may take up.
+     * A budget of 0 disables the cache.
+     */
+    FrameCache( const std::size_t = 0 );
+    ~FrameCache() = default;
+
+    /*! \brief Look up a frame in the cache
+     *
+     * Returns the cached frame and marks it as the most recently used, or a null pointer if the frame is not cached.
+     */
+    std::shared_ptr<const Eigen::ArrayXXf> find( const long );
+
+    /*! \brief Add a frame to the cache
+     *
+     * The frame becomes the most recently used one and the least recently used frames are evicted until the cache fits its budget again.
+     * Frames larger than the budget are not cached.
+     */
+    void insert( const long, const std::shared_ptr<const Eigen::ArrayXXf>& );
+
+    /*! \brief Drop all cached frames
+     *
+     * The counters are reset as well.
+     */
+    void clear();
+
+    /*! \brief Change the budget of the cache
+     *
+     * Frames are evicted as needed to fit the new budget; a budget of 0 disables the cache.
+     */
+    void setBudget( const std::size_t );
+
+    //! \brief Get the most memory, in bytes, the cached frames may take up
+    std::size_t budget() const;
+
+    //! \brief Get the memory, in bytes, taken up by the cached frames
+    std::size_t size() const;
+
+    //! \brief Get the number of frames found in the cache
+    std::size_t hits() const;
+
+    //! \brief Get the number of frames not found in the cache
+    std::size_t misses() const;
+
+    //! \brief Check whether the cache is enabled
+    bool enabled() const;
+
+    private:
+    typedef std::pair<long, std::shared_ptr<const Eigen::ArrayXXf>> Entry;
+
+    std::list<Entry> entries;
+    std::unordered_map<long, std::list<Entry>::iterator> index;
+    std::size_t m_budget;
+    std::size_t m_size = 0;
+    std::size_t m_hits = 0;
+    std::size_t m_misses = 0;
+    mutable std::mutex mutex;
+
+    void evict();
+};
+}
+
+#endif
@@ -0,0 +1,88 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_FRAMESTACK_H
+#define SPE_FRAMESTACK_H
+
+#include <cstddef>
+#include <vector>
+#include <Eigen/Core>
+
+#include "frame.h"
+
+namespace SPE {
+/*! \brief A stack of frames stored contiguously
+ *
+ * This class holds several frames of floating point values in one contiguous block of memory.
+ * The values are laid out frame after frame, each frame row after row, so the stack is a three-dimensional array of frames x rows x columns in C order.
+ * Individual frames can be accessed in place as row-major Eigen arrays.
+ */
+class FrameStack
+{
+    public:
+    //! \brief A view of one frame in the stack
+    typedef Eigen::Map<RowMajorArrayXXf> FrameView;
+
+    //! \brief A read-only view of one frame in the stack
+    typedef Eigen::Map<const RowMajorArrayXXf> ConstFrameView;
+
+    /*! \brief Create an empty stack of frames
+     *
+     * A stack of the given number of frames, rows and columns is created, with all values set to zero.
+     */
+    FrameStack( const std::size_t = 0, const std::size_t = 0, const std::size_t = 0 );
+    ~FrameStack() = default;
+
+    /*! \brief View one frame in the stack
+     *
+     * The view refers to the values in the stack, so changes made through the view change the stack.
+     */
+    FrameView frame( const std::size_t );
+
+    /*! \brief View one frame in the stack without changing it
+     *
+     * The view refers to the values in the stack.
+     */
+    ConstFrameView frame( const std::size_t ) const;
+
+    //! \brief Get the number of frames in the stack
+    std::size_t frames() const;
+
+    //! \brief Get the number of rows in each frame
+    std::size_t rows() const;
+
+    //! \brief Get the number of columns in each frame
+    std::size_t columns() const;
+
+    //! \brief Get the number of values in the stack
+    std::size_t size() const;
+
+    //! \brief Access the contiguous values of the stack
+    float* data();
+
+    //! \brief Access the contiguous values of the stack without changing them
+    const float* data() const;
+
+    private:
+    std::size_t m_frames;
+    std::size_t m_rows;
+    std::size_t m_columns;
+    std::vector<float> values;
+};
+}
+
+#endif
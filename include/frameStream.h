@@ -0,0 +1,118 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_FRAMESTREAM_H
+#define SPE_FRAMESTREAM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <Eigen/Core>
+
+namespace SPE {
+class File;
+
+/*! \brief A stream of all frames in an SPE file
+ *
+ * This class walks through every frame of an SPE file in order and can be used in a range-based for loop.
+ * A background thread reads and converts the frames that follow the current one, so reading from the file overlaps with whatever the caller does with each frame.
+ * The number of frames prepared ahead of the current one is the depth of the stream, so the stream holds one more frame buffer than its depth.
+ *
+ * The stream reads the file with positioned reads through the SPE::File it was created from, which must outlive the stream and must not be unmapped or read again while streaming.
+ */
+class FrameStream
+{
+    public:
+    /*! \brief An iterator over the frames of the stream
+     *
+     * This is an input iterator; the frame it refers to is only valid until the iterator is advanced.
+     */
+    class Iterator
+    {
+        public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Eigen::ArrayXXf value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Eigen::ArrayXXf* pointer;
+        typedef const Eigen::ArrayXXf& reference;
+
+        Iterator( FrameStream* = nullptr, const std::size_t = 0 );
+
+        const Eigen::ArrayXXf& operator*() const;
+        const Eigen::ArrayXXf* operator->() const;
+        Iterator& operator++();
+        bool operator==( const Iterator& ) const;
+        bool operator!=( const Iterator& ) const;
+
+        private:
+        FrameStream* stream;
+        std::size_t frame;
+    };
+
+    /*! \brief Create a stream of all frames in an SPE file
+     *
+     * The optional depth sets how many frames are read ahead of the current one and defaults to 2.
+     * Frames are only read once iteration begins.
+     */
+    FrameStream( const File&, const std::size_t = 2 );
+    FrameStream( const FrameStream& ) = delete;
+    FrameStream& operator=( const FrameStream& ) = delete;
+    ~FrameStream();
+
+    /*! \brief Start streaming frames
+     *
+     * Starts the background reader and returns an iterator to the first frame.
+     * A stream can only be iterated over once.
+     */
+    Iterator begin();
+
+    //! \brief Get an iterator past the last frame
+    Iterator end();
+
+    private:
+    const File& file;
+    const char* mapping;
+    std::size_t mappingSize;
+    std::size_t rows;
+    std::size_t columns;
+    std::size_t frames;
+    short datatype;
+
+    std::thread reader;
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::condition_variable bufferFree;
+    std::deque<Eigen::ArrayXXf> queue;
+    std::vector<Eigen::ArrayXXf> pool;
+    Eigen::ArrayXXf current;
+    bool holding = false;
+    std::exception_ptr error;
+    bool started = false;
+    bool stopped = false;
+
+    void next();
+    void readAhead();
+    template<class T> void readFrames();
+};
+}
+
+#endif
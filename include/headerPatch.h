@@ -0,0 +1,101 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_HEADERPATCH_H
+#define SPE_HEADERPATCH_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "fields.h"
+#include "metadata.h"
+#include "offsets.h"
+
+namespace SPE {
+/*! \brief Change fields in the header of SPE files in place
+ *
+ * This class collects new values for a few fields of the header and writes them into SPE files at their offsets, without reading or writing any frame data.
+ * Fields are specified by their descriptors from SPE::Field; the number of columns, rows and frames, the datatype and the last value cannot be changed.
+ *
+ * Patching is crash-safe.
+ * The new bytes are first written to a journal next to the file, named after the file with an extra .patch extension, and flushed to disk.
+ * Only then is the header changed and flushed, after which the journal is removed.
+ * If the patch is interrupted, the journal is found on the next patch of the file, or by SPE::HeaderPatch::recover(), and the patch is completed.
+ */
+class HeaderPatch
+{
+    public:
+    HeaderPatch() = default;
+    ~HeaderPatch() = default;
+
+    /*! \brief Set a new value for a field
+     *
+     * The field is specified by its descriptor from SPE::Field, for example, set<SPE::Field::exp_sec>( 0.5 ).
+     * Setting a field again replaces its earlier value.
+     * A value that cannot be stored in the field, such as comments that are not exactly five strings, throws before anything is recorded.
+     */
+    template<class FIELD> void set( const typename FIELD::value_type& value )
+    {
+        static_assert( FIELD::OFFSET != OFFSET_XDIM and FIELD::OFFSET != OFFSET_YDIM and FIELD::OFFSET != OFFSET_DATATYPE and FIELD::OFFSET != OFFSET_NUMFRAMES and FIELD::OFFSET != OFFSET_LASTVALUE, "The geometry and last value of an SPE file cannot be patched." );
+
+        FIELD::member( header ) = value;
+        header.encode<FIELD>();
+
+        // Copy the offset, as map keys are taken by reference and the descriptor's constant has no definition
+        auto& bytes = fields[ std::size_t( FIELD::OFFSET ) ];
+        bytes.resize( FIELD::LENGTH );
+        header.retrieve( bytes[ 0 ], FIELD::OFFSET, FIELD::LENGTH );
+    }
+
+    /*! \brief Take the value of a field from metadata
+     *
+     * This is the same as setting the field to its value in the metadata, such as metadata that was read from a file and then changed.
+     */
+    template<class FIELD> void set( Metadata& metadata )
+    {
+        set<FIELD>( metadata.get<FIELD>() );
+    }
+
+    /*! \brief Patch one SPE file
+     *
+     * Any interrupted patch of the file is completed first.
+     */
+    void apply( const std::string& ) const;
+
+    /*! \brief Patch several SPE files in parallel
+     *
+     * The optional number of threads defaults to 0 and uses one thread per core.
+     * Every file is patched even if some of them fail; the first error, in the order of the files, is then thrown.
+     */
+    void apply( const std::vector<std::string>&, unsigned = 0 ) const;
+
+    /*! \brief Complete an interrupted patch of an SPE file
+     *
+     * Returns whether a patch was completed.
+     * A journal that was not completely written is discarded, as the header was not changed yet.
+     */
+    static bool recover( const std::string& );
+
+    private:
+    Metadata header;
+    std::map<std::size_t, std::vector<char>> fields;
+};
+}
+
+#endif
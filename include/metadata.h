@@ -18,6 +18,7 @@
 #ifndef SPE_METADATA_H
 #define SPE_METADATA_H
 
+#include <bitset>
 #include <fstream>
 #include <cstdint>
 #include <iostream>
@@ -27,8 +28,18 @@
 #include "data.h"
 #include "roiData.h"
 #include "calibrationData.h"
+#include "offsets.h"
 
 namespace SPE {
+class Writer;
+
+namespace Field {
+struct xdim;
+struct datatype;
+struct ydim;
+struct NumFrames;
+}
+
 /*! \brief Binary data present in an SPE file header
  *
  * This struct contains all the metadata present in the header of the SPE file.
@@ -49,9 +60,92 @@ struct Metadata : public Data
      *
      * This method extracts the binary metadata from an open SPE file.
      * The extracted bytes are stored internally for further processing.
+     * The whole header is read at once and the ROI info blocks and calibration data blocks are decoded from it, so the file is only read once.
      */
     void read( std::ifstream& );
 
+    /*! \brief Read metadata from an SPE file open as a file descriptor
+     *
+     * This method reads the header just like SPE::Metadata::read(), but with a single positioned read that does not move the file position.
+     */
+    void read( const int );
+
+    /*! \brief Load metadata from an opened SPE file without decoding it
+     *
+     * This method reads the header of an open SPE file just like SPE::Metadata::read(), but only decodes the number of columns, rows and frames and the datatype.
+     * All other fields keep their default values until they are accessed through SPE::Metadata::get() or decoded together by SPE::Metadata::decode().
+     * This makes opening a file cost about as much as the fields that are actually used.
+     *
+     * Code using lazily loaded metadata must read fields through SPE::Metadata::get(), as the public members still hold their default values until then.
+     * Changes are best made to the value returned by get() as well.
+     * A member assigned directly without get() is still written back by SPE::Metadata::encode(), unless it was assigned its default value, which cannot be told apart from a member that was never touched.
+     */
+    void load( std::ifstream& );
+
+    /*! \brief Load metadata from an SPE file open as a file descriptor without decoding it
+     *
+     * This method reads the header just like SPE::Metadata::load(), but with a single positioned read that does not move the file position.
+     */
+    void load( const int );
+
+    /*! \brief Decode all fields of loaded metadata
+     *
+     * This method decodes every field from the header read by SPE::Metadata::load().
+     * Any changes made to the fields since then are overwritten.
+     */
+    void decode();
+
+    /*! \brief Encode all fields into binary data
+     *
+     * This method is the inverse of SPE::Metadata::decode().
+     * The fields are stored into the header as binary data, ready to be written to an SPE file.
+     * Bytes of the header that do not belong to any field, as well as fields of lazily loaded metadata that were neither decoded nor assigned, are left unchanged.
+     */
+    void encode();
+
+    /*! \brief Write metadata to an SPE file
+     *
+     * This method encodes all fields and writes the header to an SPE file opened for writing.
+     */
+    void write( std::ostream& );
+
+    /*! \brief Write metadata to an SPE file open as a file descriptor
+     *
+     * This method encodes all fields and writes the header just like SPE::Metadata::write(), but with a single positioned write that does not move the file position.
+     */
+    void write( const int );
+
+    /*! \brief Get a field, decoding it on first access
+     *
+     * The field is specified by its descriptor from SPE::Field, for example, get<SPE::Field::exp_sec>().
+     * The first access decodes the field from the header and stores it in the corresponding public member.
+     * Subsequent accesses return the stored value without decoding it again.
+     * Fields of metadata read with SPE::Metadata::read() are already decoded.
+     * A field that was assigned a new value before it was ever decoded keeps that value.
+     */
+    template<class FIELD> const typename FIELD::value_type& get()
+    {
+        auto& value = FIELD::member( *this );
+        if ( not decoded.test( FIELD::OFFSET ) ) {
+            // A member that was assigned before it was ever decoded keeps its new value
+            if ( not assigned<FIELD>() ) decodeField( value, FIELD::OFFSET, FIELD::LENGTH );
+            decoded.set( FIELD::OFFSET );
+        }
+
+        return value;
+    }
+
+    /*! \brief Encode a single field into binary data
+     *
+     * The field is specified by its descriptor from SPE::Field, just like with SPE::Metadata::get().
+     * Only the bytes of this field in the header are changed, ready to be written to an SPE file.
+     */
+    template<class FIELD> void encode()
+    {
+        encodeField( FIELD::member( *this ), FIELD::OFFSET, FIELD::LENGTH );
+        decoded.set( FIELD::OFFSET );
+    }
+
     //! \brief Hardware Version
     std::int16_t ControllerVersion = 0;
 
@@ -538,18 +632,56 @@ struct Metadata : public Data
     std::int16_t lastvalue = 0;
 
     private:
+    friend class Writer;
+    friend struct Field::xdim;
+    friend struct Field::datatype;
+    friend struct Field::ydim;
+    friend struct Field::NumFrames;
+
+    struct Decoder;
+    struct Encoder;
+
     std::uint16_t m_xdim = 0;
     std::int16_t m_datatype = 0;
     std::uint16_t m_ydim = 0;
     std::int32_t m_NumFrames = 0;
 
-    const std::size_t DATEMAX = 10; // String length of file creation data string as ddmmmyyyy\0
-    const std::size_t TIMEMAX = 7; // Max time store as hhmmss\0
-    const std::size_t COMMENTMAX = 80; // User comment string max length (5 comments)
-    const std::size_t LABELMAX = 16; // Label string max length
-    const std::size_t FILEVERMAX = 16; // File version string max length
-    const std::size_t HDRNAMEMAX = 120; // Max char str length for file name
-    const std::size_t ROIMAX = 10; // Max size of roi array of structures
+    // Fields that have been decoded, marked by their offset in the header
+    std::bitset<OFFSET_DATA> decoded;
+
+    // The values of the fields of loaded metadata before they are decoded
+    static const Metadata& defaults();
+
+    // Whether a field that was never decoded has been assigned a new value directly
+    template<class FIELD> bool assigned() const
+    {
+        return not ( FIELD::member( *this ) == FIELD::member( defaults() ) );
+    }
+
+    template<class T> void decodeField( T& value, const std::size_t BYTE_OFFSET, const std::size_t DATA_LENGTH )
+    {
+        retrieve( value, BYTE_OFFSET, DATA_LENGTH );
+    }
+
+    template<class T> void decodeField( std::vector<T>& value, const std::size_t BYTE_OFFSET, const std::size_t DATA_LENGTH )
+    {
+        value.resize( DATA_LENGTH / sizeof( T ) );
+        retrieve( value[ 0 ], BYTE_OFFSET, DATA_LENGTH );
+    }
+
+    void decodeField( std::string&, const std::size_t, const std::size_t );
+    void decodeField( std::vector<std::string>&, const std::size_t, const std::size_t );
+    void decodeField( std::vector<ROIData>&, const std::size_t, const std::size_t );
+    void decodeField( CalibrationData&, const std::size_t, const std::size_t );
+
+    template<class T> void encodeField( const T& value, const std::size_t BYTE_OFFSET, const std::size_t DATA_LENGTH )
+    {
+        store( value, BYTE_OFFSET, DATA_LENGTH );
+    }
+
+    void encodeField( const std::vector<std::string>&, const std::size_t, const std::size_t );
+    void encodeField( std::vector<ROIData>&, const std::size_t, const std::size_t );
+    void encodeField( CalibrationData&, const std::size_t, const std::size_t );
 
     virtual void reset();
 };
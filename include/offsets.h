@@ -19,6 +19,7 @@
 #define SPE_OFFSETS_H
 
 #include <cstddef>
+#include <cstdint>
 
 // Offsets and description from SPE 2.5 specification
 
@@ -175,7 +176,7 @@ const std::size_t OFFSET_ROIINFOBLK_8           = 0x0648;   // ROI Starting Offs
 const std::size_t OFFSET_ROIINFOBLK_9           = 0x0654;   // ROI Starting Offsets: ROI 10 = 1620
 const std::size_t OFFSET_FLATFIELD              = 0x0660;   // Flat field file name
 const std::size_t OFFSET_BACKGROUND             = 0x06D8;   // background sub. file name
-const std::size_t OFFSET_BLEMISH                = 0x0650;   // blemish file name
+const std::size_t OFFSET_BLEMISH                = 0x0750;   // blemish file name
 const std::size_t OFFSET_FILE_HEADER_VER        = 0x07C8;   // version of this file header
 const std::size_t OFFSET_YT_INFO                = 0x07CC;   // Reserved for YT information
 const std::size_t OFFSET_WINVIEW_ID             = 0x0BB4;   // == 0x01234567L if file created by WinX
@@ -200,5 +201,16 @@ const std::size_t OFFSET_AVGAIN                 = 0x1000;   // avalanche gain va
 const std::size_t OFFSET_LASTVALUE              = 0x1002;   // Always the last value in the header
 const std::size_t OFFSET_DATA                   = 0x1004;   // Start of data
 
+// Values from SPE 2.5 specification
+
+const std::size_t DATEMAX                       = 10;       // String length of file creation data string as ddmmmyyyy\0
+const std::size_t TIMEMAX                       = 7;        // Max time store as hhmmss\0
+const std::size_t COMMENTMAX                    = 80;       // User comment string max length (5 comments)
+const std::size_t LABELMAX                      = 16;       // Label string max length
+const std::size_t FILEVERMAX                    = 16;       // File version string max length
+const std::size_t HDRNAMEMAX                    = 120;      // Max char str length for file name
+const std::size_t ROIMAX                        = 10;       // Max size of roi array of structures
+const std::int16_t LASTVALUE                    = 0x5555;   // Always the last value in the header
+
 #endif
 
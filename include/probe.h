@@ -0,0 +1,63 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_PROBE_H
+#define SPE_PROBE_H
+
+#include <cstdint>
+#include <string>
+
+namespace SPE {
+/*! \brief Core properties of an SPE file
+ *
+ * This struct contains the few header values needed to catalogue an SPE file without reading its full metadata.
+ * The values are named exactly as in the specification.
+ */
+struct Probe
+{
+    //! \brief actual # of pixels on x axis
+    std::uint16_t xdim = 0;
+
+    //! \brief y dimension of raw data
+    std::uint16_t ydim = 0;
+
+    //! \brief experiment datatype (0 = float, 1 = long, 2 = short, 3 = unsigned short)
+    std::int16_t datatype = 0;
+
+    //! \brief number of frames in file
+    std::int32_t NumFrames = 0;
+
+    //! \brief Always the last value in the header
+    std::int16_t lastvalue = 0;
+
+    /*! \brief Whether the file looks like a valid SPE file
+     *
+     * A file is valid if it could be read, its header ends with the expected last value, its datatype is known and it is large enough to hold all of its frames.
+     */
+    bool valid = false;
+};
+
+/*! \brief Read the core properties of an SPE file
+ *
+ * This is a lightweight alternative to SPE::File for when only the geometry, datatype and number of frames are needed.
+ * The header is fetched with a single positioned read and only the core values are decoded from it.
+ * No exception is thrown for missing or malformed files; they are reported as invalid instead.
+ */
+Probe probe( const std::string& );
+}
+
+#endif
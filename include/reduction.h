@@ -0,0 +1,72 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_REDUCTION_H
+#define SPE_REDUCTION_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+
+#include "statistics.h"
+
+namespace SPE {
+/*! \brief Read a run of pixels of one frame
+ *
+ * Reductions read their frames through a function of this type, given the index of the frame, the index of the first pixel and the number of pixels.
+ * The pixels are either read into the given buffer, which has room for them, or viewed in place, such as in a memory-mapped file.
+ * The function returns a pointer to the pixels in the datatype of the file.
+ */
+template<class T> using PixelReader = std::function<const T*( const std::size_t, const std::size_t, const std::size_t, T* )>;
+
+/*! \brief Average frames on a pool of threads
+ *
+ * The frames are given as blocks of consecutive frames, each the index of its first frame and its number of frames.
+ * Each thread sums whole blocks in double precision, taking the next block once it is done with one.
+ * The block sums are added up in the order of the blocks, so the result does not depend on the number of threads.
+ *
+ * \param rows The number of rows in each frame
+ * \param columns The number of columns in each frame
+ * \param blocks The blocks of frames to average
+ * \param threads The number of threads to use, 0 to use one per core
+ * \param read The function to read frames with
+ * \return The average frame
+ */
+template<class T> Eigen::ArrayXXf averageFrames( const std::size_t rows, const std::size_t columns, const std::vector<std::pair<std::size_t, std::size_t>>& blocks, unsigned threads, const PixelReader<T>& read );
+
+/*! \brief Calculate per-pixel statistics across frames on a pool of threads
+ *
+ * The frame is split into tiles of consecutive pixels that are processed in parallel; each tile is read from every frame in turn.
+ * Means and variances are accumulated with Welford's method in double precision and medians are selected from the values of each pixel across all frames.
+ * Tiles are sized so the working memory of all threads together fits in the memory budget, in bytes.
+ * The result does not depend on the number of threads or the memory budget.
+ *
+ * \param rows The number of rows in each frame
+ * \param columns The number of columns in each frame
+ * \param frames The number of frames
+ * \param quantities The statistics to calculate, a bitwise or of Statistics::Quantity values
+ * \param memoryBudget The approximate number of bytes of working memory to use
+ * \param threads The number of threads to use, 0 to use one per core
+ * \param read The function to read frames with
+ * \return The requested statistics
+ */
+template<class T> Statistics frameStatistics( const std::size_t rows, const std::size_t columns, const std::size_t frames, const unsigned quantities, const std::size_t memoryBudget, unsigned threads, const PixelReader<T>& read );
+}
+
+#endif
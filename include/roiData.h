@@ -47,6 +47,43 @@ struct ROIData : public Data
      */
     void read( std::ifstream& );
 
+    /*! \brief Read data from the header of an SPE file
+     *
+     * This method extracts the binary data comprising an ROI info block from the header that has already been read from an SPE file.
+     * The file itself is not accessed again.
+     */
+    void read( const Data& );
+
+    /*! \brief Write data to an SPE file
+     *
+     * This method stores the fields of an ROI info block as binary data and writes it to an SPE file opened for writing.
+     */
+    void write( std::ostream& );
+
+    /*! \brief Write data into the header of an SPE file
+     *
+     * This method stores the fields of an ROI info block as binary data and copies it into the header, ready to be written to an SPE file.
+     */
+    void write( Data& );
+
+    /*! \brief Compare the fields of two ROI info blocks
+     *
+     * Two blocks are equal if all their fields are, wherever they are stored in the header.
+     */
+    bool operator==( const ROIData& ) const;
+
+    /*! \brief Get the number of rows of pixels in the ROI
+     *
+     * This is the number of rows the ROI occupies in a frame after binning, ( endy - starty + 1 ) / groupy.
+     */
+    std::size_t rows() const;
+
+    /*! \brief Get the number of columns of pixels in the ROI
+     *
+     * This is the number of columns the ROI occupies in a frame after binning, ( endx - startx + 1 ) / groupx.
+     */
+    std::size_t columns() const;
+
     //! \brief left x start value
     std::uint16_t startx = 0;
 
@@ -66,6 +103,8 @@ struct ROIData : public Data
     std::uint16_t groupy = 0;
 
     private:
+    void decode();
+    void encode();
     virtual void reset();
 };
 }
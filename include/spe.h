@@ -18,12 +18,24 @@
 #ifndef SPE_FILE_H
 #define SPE_FILE_H
 
+#include <algorithm>
+#include <memory>
 #include <string>
-#include <fstream>
+#include <vector>
+#include <stdexcept>
 #include <Eigen/Core>
 
 #include "metadata.h"
+#include "fields.h"
 #include "offsets.h"
+#include "datatype.h"
+#include "frame.h"
+#include "frameStack.h"
+#include "frameCache.h"
+#include "frameStream.h"
+#include "statistics.h"
+#include "convert.h"
+#include "probe.h"
 
 namespace SPE {
 /*! \brief An SPE file
@@ -33,6 +45,10 @@ namespace SPE {
  * The data could be an image (multiple rows, multiple columns) or a spectrum (single row, multiple columns).
  *
  * This release of libspe supports SPE version 2.5 headers.
+ *
+ * Frames are read with positioned reads that do not share a file position, so one instance can be read from several threads at once.
+ * All methods that fetch pixels, frames or statistics, such as SPE::File::getFrame() and SPE::File::getPixel(), may be called concurrently, including with the frame cache enabled.
+ * Methods that change the instance itself, SPE::File::read(), SPE::File::map(), SPE::File::unmap() and SPE::File::setCacheBudget(), as well as changes to the metadata, must not overlap with any other call.
  */
 class File
 {
@@ -47,8 +63,11 @@ class File
      *
      * The provided path is used to open an SPE file and read in the header containing metadata about the file.
      * Image data, in the form of frames can be extracted when needed.
+     * Optionally, the metadata can be loaded lazily, in which case fields are only decoded when accessed through SPE::Metadata::get().
      */
-    File( const std::string& );
+    File( const std::string&, const bool = false );
+    File( const File& ) = delete;
+    File& operator=( const File& ) = delete;
     ~File();
 
     /*! \brief Open an SPE file for reading
@@ -56,8 +75,9 @@ class File
      * This method opens an SPE file and extracts metadata from the header.
      * The file is kept open for subsequent methods to retrieve image data.
      * If this instance of SPE::File was initialized with another file path, the earlier metadata and file handle are replaced.
+     * Optionally, the metadata can be loaded lazily, in which case fields are only decoded when accessed through SPE::Metadata::get().
      */
-    void read( const std::string& );
+    void read( const std::string&, const bool = false );
 
     /*! \brief Get intensity of a specified pixel
      *
@@ -66,6 +86,22 @@ class File
      */
     float getPixel( const unsigned short, const unsigned short, const long = 0 );
 
+    /*! \brief Get the intensity of a specified pixel in every frame
+     *
+     * Fetches the time series of one pixel across all frames of the image as an array with one value per frame.
+     * See SPE::File::getPixelTraces() for how the samples are read.
+     */
+    Eigen::ArrayXf getPixelTrace( const unsigned short, const unsigned short );
+
+    /*! \brief Get the intensities of several pixels in every frame
+     *
+     * Fetches the time series of each given pixel, as a pair of row and column, across all frames of the image.
+     * The result has one row per frame and one column per pixel, so the trace of each pixel is contiguous in memory.
+     * When the requested pixels lie close together in the file, consecutive frames are read in large chunks; otherwise only the stretches of each frame holding the pixels are read.
+     * If the file is mapped, the samples are gathered directly from the mapping.
+     */
+    Eigen::ArrayXXf getPixelTraces( const std::vector<std::pair<unsigned short, unsigned short>>& );
+
     /*! \brief Get one frame of data
      *
      * Fetches the specified frame from the file in the form of an Eigen::ArrayXXf of floating point values.
@@ -74,12 +110,212 @@ class File
      */
     Eigen::ArrayXXf getFrame( const long = 0 );
 
+    /*! \brief Get one frame of data without copying it
+     *
+     * Fetches the specified frame just like SPE::File::getFrame(), but as a shared, read-only frame.
+     * If the frame cache is enabled, a cached frame is handed out without being copied and a newly decoded frame is added to the cache.
+     * If the optional frame number is not provided, it defaults to 0 and fetches the first frame.
+     */
+    std::shared_ptr<const Eigen::ArrayXXf> getSharedFrame( const long = 0 );
+
+    /*! \brief Enable the frame cache
+     *
+     * Frames fetched with SPE::File::getFrame() and SPE::File::getSharedFrame() are kept in memory, up to the given budget in bytes, and evicted least recently used first.
+     * Fetching a cached frame costs a copy, or nothing at all with SPE::File::getSharedFrame(), instead of reading and decoding it again.
+     * The cache is disabled by default; a budget of 0 disables it again and releases the cached frames.
+     */
+    void setCacheBudget( const std::size_t );
+
+    /*! \brief Access the frame cache
+     *
+     * The cache reports its budget, its size and the number of hits and misses so far.
+     */
+    const FrameCache& frameCache() const;
+
+    /*! \brief Get one frame of data laid out row-major
+     *
+     * Fetches the specified frame just like SPE::File::getFrame(), but as a row-major array of floating point values.
+     * Since frames are stored row-major in the SPE file, this is a straight sequential conversion without the transpose needed for a column-major array.
+     * This suits code that works on one row (spectrum) at a time.
+     * For a row-major view without any conversion, map the file and use SPE::File::mapFrame().
+     * If the optional frame number is not provided, it defaults to 0 and fetches the first frame.
+     */
+    RowMajorArrayXXf getRowMajorFrame( const long = 0 );
+
+    /*! \brief Get one region of interest of one frame of data
+     *
+     * Frames acquired with several regions of interest (ROIs) hold the pixels of each ROI one after the other, as described by SPE::Metadata::NumROI and SPE::Metadata::ROIinfoblk.
+     * This method fetches one ROI of the specified frame as an Eigen::ArrayXXf of floating point values, with the binned dimensions given by SPE::ROIData::rows() and SPE::ROIData::columns().
+     * Only the bytes of the requested ROI are read.
+     * If the header does not describe ROIs that add up to a frame, the whole frame is treated as a single ROI.
+     */
+    Eigen::ArrayXXf getROI( const long, const std::size_t );
+
+    /*! \brief Get several regions of interest of one frame of data
+     *
+     * Fetches the given ROIs of the specified frame like SPE::File::getROI(), in the order they are requested.
+     * The bytes of ROIs that are not requested are skipped.
+     */
+    std::vector<Eigen::ArrayXXf> getROIs( const long, const std::vector<std::size_t>& );
+
+    /*! \brief Get one frame of data binned in software
+     *
+     * Fetches the specified frame with every groupy rows and groupx columns of pixels combined into one bin, like the hardware binning described by SPE::ROIData::groupx and SPE::ROIData::groupy.
+     * The binned frame has xdim / groupx columns and ydim / groupy rows; pixels left over at the end of a row or column are dropped.
+     * Setting groupy to the number of rows bins the frame fully vertically into a spectrum.
+     * The bins hold the sum of their pixels, or the mean if the optional flag is set.
+     * Binning happens while the frame is decoded, a few rows at a time, so the full-resolution frame is never held in memory.
+     */
+    Eigen::ArrayXXf getBinnedFrame( const long, const unsigned short, const unsigned short, const bool = false );
+
+    /*! \brief Get a rectangular region of one frame of data
+     *
+     * Fetches the region of the specified frame starting at the given row and column and spanning the given number of rows and columns, as an Eigen::ArrayXXf of floating point values.
+     * Only the stretches of the frame covering the region are read, so the cost scales with the size of the region rather than the size of the frame.
+     * Rows of the region that lie close together in the file are read in one go.
+     */
+    Eigen::ArrayXXf getFrameRegion( const long, const unsigned short, const unsigned short, const unsigned short, const unsigned short );
+
+    /*! \brief Get the same rectangular region of several frames of data
+     *
+     * Fetches the region starting at the given row and column and spanning the given number of rows and columns, from count frames starting at frame first, into one SPE::FrameStack.
+     * Like SPE::File::getFrameRegion(), only the stretches of each frame covering the region are read, and consecutive frames are read together when the region nearly covers them.
+     */
+    FrameStack getFrameRegions( const long, const long, const unsigned short, const unsigned short, const unsigned short, const unsigned short );
+
     /*! \brief Get the average of all frames in the image
      *
      * This method calculates the mean intensity of all the pixels forming the image.
      * The average of all the frames of data is returned.
+     * Frames are summed in double precision by several threads, each working through blocks of consecutive frames.
+     * The block sums are always added up in the same order, so the result does not depend on the number of threads.
+     * If the optional number of threads is not provided, it defaults to 0 and uses one thread per core.
+     */
+    Eigen::ArrayXXf getAverageFrame( const unsigned = 0 );
+
+    /*! \brief Get per-pixel statistics across all frames in the image
+     *
+     * This method calculates any combination of the mean, variance, standard deviation, minimum, maximum and median intensity of each pixel over all frames, given as SPE::Statistics::Quantity values combined with a bitwise or.
+     * All requested statistics are calculated in a single pass over the file.
+     * The frame is split into tiles of pixels that are processed in parallel, each tile reading its part of every frame and updating the mean and variance with Welford's method.
+     * For the median, the intensities of all frames are kept for the pixels of a tile and the middle value is selected in place.
+     * The optional memory budget, in bytes, limits the working memory of all threads together and sets the size of the tiles; the result arrays are not counted.
+     * If the optional number of threads is not provided, it defaults to 0 and uses one thread per core.
+     * The result does not depend on the number of threads or the size of the tiles.
      */
-    Eigen::ArrayXXf getAverageFrame();
+    Statistics getStatistics( const unsigned = Statistics::ALL, const std::size_t = 256 << 20, const unsigned = 0 );
+
+    /*! \brief Get several frames of data as one contiguous stack
+     *
+     * Fetches count frames, starting at frame first and stepping by stride frames, into one SPE::FrameStack of floating point values.
+     * Consecutive frames are stored next to each other in the SPE file, so they are read in large chunks and converted in bulk instead of one frame at a time.
+     * Strided frames are read together with the frames skipped in between when the gap is small enough that one larger read is cheaper than many smaller ones.
+     * If the optional stride is not provided, it defaults to 1 and fetches consecutive frames.
+     */
+    FrameStack getFrames( const long, const long, const long = 1 );
+
+    /*! \brief Get one frame of data in the datatype of the file
+     *
+     * Fetches the specified frame just like SPE::File::getFrame(), but without converting the pixel intensities to floating point values.
+     * The frame takes up only as much memory as it does in the file.
+     * The requested type must match SPE::Metadata::datatype(), for example, std::uint16_t for datatype 3.
+     * If the optional frame number is not provided, it defaults to 0 and fetches the first frame.
+     */
+    template<class T> FrameArray<T> getFrameAs( const long frame = 0 )
+    {
+        checkDatatype<T>();
+
+        Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> pixels( metadata.ydim(), metadata.xdim() );
+        readFrame( frame, pixels.data() );
+
+        return pixels;
+    }
+
+    /*! \brief Get the sum of all frames in the datatype of the file
+     *
+     * Frames are read in the datatype of the file and added up in the given accumulator type, without converting to floating point values.
+     * For example, frames of unsigned short integers can be summed as getSumFrameAs<std::uint16_t, std::uint32_t>().
+     * The accumulator type must be wide enough to hold the sum of all frames.
+     * The requested type must match SPE::Metadata::datatype().
+     */
+    template<class T, class ACCUMULATOR> FrameArray<ACCUMULATOR> getSumFrameAs()
+    {
+        checkDatatype<T>();
+
+        FrameArray<ACCUMULATOR> sumFrame = FrameArray<ACCUMULATOR>::Zero( metadata.ydim(), metadata.xdim() );
+        Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> pixels( metadata.ydim(), metadata.xdim() );
+
+        for ( auto frame = 0; frame < metadata.NumFrames(); ++frame ) {
+            if ( isMapped() ) {
+                sumFrame += mapFrame<T>( frame ).template cast<ACCUMULATOR>();
+            } else {
+                readFrame( frame, pixels.data() );
+                sumFrame += pixels.template cast<ACCUMULATOR>();
+            }
+        }
+
+        return sumFrame;
+    }
+
+    /*! \brief Map the SPE file into memory
+     *
+     * This method memory-maps the whole SPE file for reading.
+     * Once mapped, frames can be viewed in place with SPE::File::mapFrame() and all other methods read from the mapping instead of the file stream.
+     * The mapping is released by SPE::File::unmap(), when another file is read or when this instance is destroyed.
+     */
+    void map();
+
+    /*! \brief Release the memory mapping of the SPE file
+     *
+     * Any views obtained from SPE::File::mapFrame() are no longer valid once the mapping is released.
+     */
+    void unmap();
+
+    /*! \brief Check whether the SPE file is memory-mapped
+     *
+     * This is true between calls to SPE::File::map() and SPE::File::unmap().
+     */
+    bool isMapped() const;
+
+    /*! \brief View one frame of data in place
+     *
+     * Returns a read-only view of the specified frame directly over the memory-mapped file, in the datatype used by the file.
+     * Nothing is read or copied, so accessing the view costs no more than the page faults needed to bring the frame into memory.
+     * The file must have been mapped with SPE::File::map() and the requested type must match SPE::Metadata::datatype().
+     * If the optional frame number is not provided, it defaults to 0 and views the first frame.
+     */
+    template<class T> FrameMap<T> mapFrame( const long frame = 0 ) const
+    {
+        if ( not isMapped() ) throw std::runtime_error( "File is not mapped into memory." );
+        checkDatatype<T>();
+        if ( frame < 0 or frame >= metadata.NumFrames() ) throw std::out_of_range( "Frame does not exist in the file." );
+
+        const std::size_t frameDim = metadata.xdim() * metadata.ydim();
+        const std::size_t offset = OFFSET_DATA + ( sizeof( T ) * frameDim * frame );
+        if ( offset + ( sizeof( T ) * frameDim ) > mappingSize ) throw std::out_of_range( "Frame extends beyond the end of the file." );
+
+        return FrameMap<T>( reinterpret_cast<const T*>( mapping + offset ), metadata.ydim(), metadata.xdim() );
+    }
+
+    /*! \brief View one region of interest of one frame of data in place
+     *
+     * Returns a read-only view of one ROI of the specified frame directly over the memory-mapped file, in the datatype used by the file.
+     * Each ROI is stored contiguously in the file, so nothing is read or copied.
+     * The same conditions as for SPE::File::mapFrame() apply.
+     */
+    template<class T> FrameMap<T> mapROI( const long frame, const std::size_t roi )
+    {
+        std::size_t offset, rows, cols;
+        roiLayout( roi, offset, rows, cols );
+
+        return FrameMap<T>( mapFrame<T>( frame ).data() + offset, rows, cols );
+    }
+
+    /*! \brief Get the number of regions of interest in each frame
+     *
+     * This is SPE::Metadata::NumROI if the ROIs described in the header add up to a frame, or 1 otherwise.
+     */
+    std::size_t rois();
 
     /*! \brief Get the number of rows in the image
      *
@@ -104,43 +340,123 @@ class File
      * This metadata instance provides direct access to available metadata in the header of the SPE file.
      * Some important values are protected and only available for reading.
      * Modifications to metadata only affect this internal representation and will not alter the SPE file itself in any way.
+     * To change fields in the SPE file itself, use SPE::HeaderPatch.
      */
     Metadata metadata;
 
     private:
-    std::ifstream file;
+    friend class FrameStream;
+    friend class Writer;
+    friend class Dataset;
 
-    template<class T> float getPixelValue( const unsigned short row, const unsigned short col, const long frame )
+    int fileDescriptor = -1;
+    std::string filePath;
+    const char* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    FrameCache cache;
+
+    Eigen::ArrayXXf decodeFrame( const long );
+
+    template<class T> void checkDatatype() const
     {
+        if ( Datatype<T>::VALUE != metadata.datatype() ) throw std::runtime_error( "Requested type does not match the datatype of the file." );
+    }
+
+    template<class T> void readFrame( const long frame, T* pixels ) const
+    {
+        const std::size_t frameDim = metadata.xdim() * metadata.ydim();
+
+        if ( isMapped() ) {
+            std::copy_n( mapFrame<T>( frame ).data(), frameDim, pixels );
+            return;
+        }
+
+        const std::size_t offset = OFFSET_DATA + ( sizeof( T ) * frameDim * frame );
+        readBytes( reinterpret_cast<char*>( pixels ), sizeof( T ) * frameDim, offset );
+    }
+
+    template<class T> const T* readPixels( const std::size_t frame, const std::size_t first, const std::size_t count, T* buffer ) const
+    {
+        // A mapped file is viewed in place and the buffer is left untouched
+        if ( isMapped() ) return mapFrame<T>( frame ).data() + first;
+
+        const std::size_t frameSize = sizeof( T ) * metadata.xdim() * metadata.ydim();
+        readBytes( reinterpret_cast<char*>( buffer ), sizeof( T ) * count, OFFSET_DATA + ( frameSize * frame ) + ( sizeof( T ) * first ) );
+        return buffer;
+    }
+
+    template<class T> float getPixelValue( const unsigned short row, const unsigned short col, const long frame ) const
+    {
+        if ( isMapped() ) return mapFrame<T>( frame )( row, col );
+
         T pixel;
         const std::size_t offset = OFFSET_DATA + ( sizeof( pixel ) * ( ( metadata.xdim() * metadata.ydim() * frame ) + ( metadata.xdim() * row ) + col ) );
-        Data pixelData( offset, sizeof( pixel ) );
-        pixelData.read( file );
-        pixelData.retrieve( pixel );
+        readBytes( reinterpret_cast<char*>( &pixel ), sizeof( pixel ), offset );
         return pixel;
     }
 
-    template<class T> Eigen::ArrayXXf getFrameArray( const long frame )
+    template<class T> Eigen::ArrayXXf getFrameArray( const long frame ) const
     {
         Eigen::ArrayXXf frameArray( metadata.ydim(), metadata.xdim() );
-        const std::size_t frameDim = metadata.xdim() * metadata.ydim();
-        const std::size_t frameSize = frameDim * sizeof( T );
-        const std::size_t offset = OFFSET_DATA + ( frameSize * frame );
-
-        std::vector<T> pixels( frameDim, 0 );
-        Data frameData( offset, frameSize );
-        frameData.read( file );
-        frameData.retrieve( *pixels.data(), 0, frameSize );
-
-        auto count = 0;
-        for ( auto row = 0; row < metadata.ydim(); ++row ) {
-            for ( auto col = 0; col < metadata.xdim(); ++col ) {
-                frameArray( row, col ) = pixels.at( count++ );
-            }
+
+        if ( isMapped() ) {
+            convertFrame( mapFrame<T>( frame ).data(), frameArray.data(), metadata.ydim(), metadata.xdim() );
+        } else {
+            std::vector<T> pixels( metadata.xdim() * metadata.ydim() );
+            readFrame( frame, pixels.data() );
+            convertFrame( pixels.data(), frameArray.data(), metadata.ydim(), metadata.xdim() );
+        }
+
+        return frameArray;
+    }
+
+    template<class T> RowMajorArrayXXf getRowMajorFrameArray( const long frame ) const
+    {
+        RowMajorArrayXXf frameArray( metadata.ydim(), metadata.xdim() );
+
+        if ( isMapped() ) {
+            convertPixels( mapFrame<T>( frame ).data(), frameArray.data(), frameArray.size() );
+        } else {
+            std::vector<T> pixels( frameArray.size() );
+            readFrame( frame, pixels.data() );
+            convertPixels( pixels.data(), frameArray.data(), frameArray.size() );
         }
 
         return frameArray;
     }
+
+    void readBytes( char*, const std::size_t, const std::size_t ) const;
+    void roiLayout( const std::size_t, std::size_t&, std::size_t&, std::size_t& );
+
+    template<class T> std::vector<Eigen::ArrayXXf> getROIArrays( const long frame, const std::vector<std::size_t>& rois )
+    {
+        const std::size_t frameSize = sizeof( T ) * metadata.xdim() * metadata.ydim();
+
+        std::vector<Eigen::ArrayXXf> roiArrays;
+        std::vector<T> pixels;
+        for ( auto roi : rois ) {
+            std::size_t offset, rows, cols;
+            roiLayout( roi, offset, rows, cols );
+            roiArrays.emplace_back( rows, cols );
+
+            if ( isMapped() ) {
+                convertFrame( mapFrame<T>( frame ).data() + offset, roiArrays.back().data(), rows, cols );
+            } else {
+                pixels.resize( rows * cols );
+                readBytes( reinterpret_cast<char*>( pixels.data() ), sizeof( T ) * pixels.size(), OFFSET_DATA + ( frameSize * frame ) + ( sizeof( T ) * offset ) );
+                convertFrame( pixels.data(), roiArrays.back().data(), rows, cols );
+            }
+        }
+
+        return roiArrays;
+    }
+
+    template<class T> Eigen::ArrayXXf getAverageFrameArray( unsigned ) const;
+    template<class T> Statistics getStatisticsArrays( const unsigned, const std::size_t, unsigned ) const;
+    template<class T> Eigen::ArrayXXf getPixelTraceArrays( const std::vector<std::size_t>& ) const;
+    template<class T> Eigen::ArrayXXf getBinnedFrameArray( const long, const std::size_t, const std::size_t, const bool ) const;
+    template<class T> void readFrameRegions( const long, const std::size_t, const std::size_t, FrameStack& ) const;
+    template<class T> void readFrames( const long, const long, FrameStack& ) const;
 };
 }
 
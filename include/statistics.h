@@ -0,0 +1,62 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_STATISTICS_H
+#define SPE_STATISTICS_H
+
+#include <Eigen/Core>
+
+namespace SPE {
+/*! \brief Per-pixel statistics across all frames of an SPE file
+ *
+ * Each array has the dimensions of one frame and holds one statistic of the intensities of each pixel over all frames.
+ * Only the requested statistics are calculated; the arrays for the others are left empty.
+ */
+struct Statistics
+{
+    //! \brief The statistics that can be requested, combined with a bitwise or
+    enum Quantity {
+        MEAN = 1 << 0,
+        VARIANCE = 1 << 1,
+        DEVIATION = 1 << 2,
+        MINIMUM = 1 << 3,
+        MAXIMUM = 1 << 4,
+        MEDIAN = 1 << 5,
+        ALL = ( 1 << 6 ) - 1
+    };
+
+    //! \brief The mean intensity of each pixel
+    Eigen::ArrayXXf mean;
+
+    //! \brief The variance of the intensity of each pixel, normalized by the number of frames
+    Eigen::ArrayXXf variance;
+
+    //! \brief The standard deviation of the intensity of each pixel, normalized by the number of frames
+    Eigen::ArrayXXf deviation;
+
+    //! \brief The lowest intensity of each pixel
+    Eigen::ArrayXXf minimum;
+
+    //! \brief The highest intensity of each pixel
+    Eigen::ArrayXXf maximum;
+
+    //! \brief The median intensity of each pixel, the mean of the two middle values for an even number of frames
+    Eigen::ArrayXXf median;
+};
+}
+
+#endif
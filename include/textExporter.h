@@ -0,0 +1,96 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_TEXTEXPORTER_H
+#define SPE_TEXTEXPORTER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+#include "frameStack.h"
+
+namespace SPE {
+class File;
+
+/*! \brief Export frames to text files
+ *
+ * This class writes frames of floating point values to a text file, one frame after the other, as they are handed to it.
+ * Each row of a frame is written on its own line with the values separated by a delimiter, and frames are separated by an empty line.
+ * By default, values are written with the fewest digits that read back to exactly the same value; a fixed number of significant digits can be set instead.
+ * Values are formatted into a reusable buffer that is written out in large blocks, so no memory is allocated per value.
+ */
+class TextExporter
+{
+    public:
+    /*! \brief Create a text file
+     *
+     * An existing file at the path is overwritten.
+     * The optional precision is the number of significant digits of each value; 0, the default, writes the shortest representation that reads back exactly.
+     * The optional delimiter separates the values in a row and defaults to a space.
+     */
+    TextExporter( const std::string&, const int = 0, const char = ' ' );
+    TextExporter( const TextExporter& ) = delete;
+    TextExporter& operator=( const TextExporter& ) = delete;
+
+    /*! \brief Close the file
+     *
+     * Errors while closing are ignored here; call SPE::TextExporter::close() to see them.
+     */
+    ~TextExporter();
+
+    //! \brief Append one frame, or a spectrum of one row
+    void write( const Eigen::Ref<const Eigen::ArrayXXf>& );
+
+    //! \brief Append a stack of frames
+    void write( const FrameStack& );
+
+    /*! \brief Append frames read from an SPE file
+     *
+     * Fetches count frames, starting at frame first, a few at a time and appends them, so the frames are never all in memory at once.
+     */
+    void write( File&, const long, const long );
+
+    /*! \brief Write out the buffer and close the file
+     */
+    void close();
+
+    //! \brief Get the number of frames written so far
+    std::size_t frames() const;
+
+    /*! \brief Save one frame to a text file
+     *
+     * The precision and delimiter are used just like in the constructor.
+     */
+    static void save( const std::string&, const Eigen::Ref<const Eigen::ArrayXXf>&, const int = 0, const char = ' ' );
+
+    private:
+    std::string path;
+    int precision;
+    char delimiter;
+    int fileDescriptor = -1;
+    std::size_t m_frames = 0;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+
+    void writeRows( const float*, const std::size_t, const std::size_t, const std::size_t, const std::size_t );
+    void flush();
+};
+}
+
+#endif
@@ -0,0 +1,140 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPE_WRITER_H
+#define SPE_WRITER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+#include "frameStack.h"
+#include "metadata.h"
+
+namespace SPE {
+class File;
+
+/*! \brief Write SPE files
+ *
+ * This class creates an SPE 2.5 file and appends frames to it as they are handed over, so files of any length can be written without holding their frames in memory.
+ * The header is written once when the file is created, and only the number of frames is updated when the writer is closed.
+ * Frames are stored in the datatype given when the file is created; floating point values are rounded to the nearest integer and clamped to the range of integer datatypes, with NaN stored as 0.
+ * Frames are collected in a buffer and written out in large blocks.
+ */
+class Writer
+{
+    public:
+    /*! \brief Create an SPE file for frames of the given size
+     *
+     * An existing file at the path is overwritten.
+     * The optional datatype defaults to 0, floating point values; the datatypes are the same as in SPE::Metadata::datatype().
+     * The header is filled in from the optional metadata, such as that of the file the frames came from.
+     * Only the number of columns, rows and frames, the datatype and the last value of the header are set by the writer.
+     * If the metadata describes frames of another size, its regions of interest are replaced by a single one covering the whole frame.
+     */
+    Writer( const std::string&, const std::size_t, const std::size_t, const std::int16_t = 0, const Metadata& = Metadata() );
+    Writer( const Writer& ) = delete;
+    Writer& operator=( const Writer& ) = delete;
+
+    /*! \brief Close the file
+     *
+     * Errors while closing are ignored here; call SPE::Writer::close() to see them.
+     */
+    ~Writer();
+
+    /*! \brief Append one frame
+     *
+     * The frame must have the size given when the writer was created.
+     */
+    void write( const Eigen::Ref<const Eigen::ArrayXXf>& );
+
+    //! \brief Append a stack of frames
+    void write( const FrameStack& );
+
+    /*! \brief Append frames read from an SPE file
+     *
+     * Fetches count frames, starting at frame first, a few at a time and appends them.
+     * If the SPE file stores the same datatype as this one, the frames are copied unchanged, without converting them to floating point values and back.
+     */
+    void write( File&, const long, const long );
+
+    /*! \brief Write out the buffer, update the number of frames in the header and close the file
+     */
+    void close();
+
+    //! \brief Get the number of frames written so far
+    std::size_t frames() const;
+
+    private:
+    std::string path;
+    Metadata metadata;
+    int fileDescriptor = -1;
+    std::size_t frameSize;
+    std::size_t m_frames = 0;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+
+    char* reserve( const std::size_t );
+    void flush();
+
+    template<class FRAME> void encodeFrame( const Eigen::ArrayBase<FRAME>& frame )
+    {
+        if ( std::size_t( frame.rows() ) != metadata.ydim() or std::size_t( frame.cols() ) != metadata.xdim() ) throw std::runtime_error( "Frame does not match the size of the frames in " + path + "." );
+
+        switch ( metadata.datatype() ) {
+            case 0:
+                encodeFrameAs<float>( frame );
+                break;
+            case 1:
+                encodeFrameAs<std::int32_t>( frame );
+                break;
+            case 2:
+                encodeFrameAs<std::int16_t>( frame );
+                break;
+            case 3:
+                encodeFrameAs<std::uint16_t>( frame );
+                break;
+        }
+
+        ++m_frames;
+    }
+
+    template<class T, class FRAME> void encodeFrameAs( const Eigen::ArrayBase<FRAME>& frame )
+    {
+        typedef Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorArray;
+        Eigen::Map<RowMajorArray> target( reinterpret_cast<T*>( reserve( frameSize ) ), frame.rows(), frame.cols() );
+
+        if ( std::numeric_limits<T>::is_integer ) {
+            // The largest float that still fits, as the largest int32 is not a float
+            const float lowest = std::numeric_limits<T>::min();
+            float highest = std::numeric_limits<T>::max();
+            if ( double( highest ) > double( std::numeric_limits<T>::max() ) ) highest = std::nextafter( highest, 0.0f );
+
+            target = ( frame == frame ).select( frame.round().max( lowest ).min( highest ), 0.0f ).template cast<T>();
+        } else {
+            target = frame.template cast<T>();
+        }
+    }
+};
+}
+
+#endif
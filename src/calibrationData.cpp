@@ -31,7 +31,50 @@ CalibrationData::CalibrationData( const std::size_t OFFSET ) : Data( OFFSET, 489
 void CalibrationData::read( std::ifstream& file )
 {
     Data::read( file );
+    decode();
+}
+
+/*!
+ * \param header The header data to extract the calibration data block from
+ * \return void
+ */
+void CalibrationData::read( const Data& header )
+{
+    Data::read( header );
+    decode();
+}
+
+/*!
+ * \param file The file stream to write data to
+ * \return void
+ */
+void CalibrationData::write( std::ostream& file )
+{
+    encode();
+    Data::write( file );
+}
+
+/*!
+ * \param header The header data to write the calibration data block into
+ * \return void
+ */
+void CalibrationData::write( Data& header )
+{
+    encode();
+    Data::write( header );
+}
+
+/*!
+ * \param other The calibration data block to compare to
+ * \return Whether all fields of both blocks are equal
+ */
+bool CalibrationData::operator==( const CalibrationData& other ) const
+{
+    return offset == other.offset and factor == other.factor and current_unit == other.current_unit and string == other.string and calib_valid == other.calib_valid and input_unit == other.input_unit and polynom_unit == other.polynom_unit and polynom_order == other.polynom_order and calib_count == other.calib_count and pixel_position == other.pixel_position and calib_value == other.calib_value and polynom_coeff == other.polynom_coeff and laser_position == other.laser_position and new_calib_flag == other.new_calib_flag and calib_label == other.calib_label;
+}
 
+void CalibrationData::decode()
+{
     retrieve( offset, 0 );
     retrieve( factor, 8 );
     retrieve( current_unit, 16 );
@@ -49,6 +92,25 @@ void CalibrationData::read( std::ifstream& file )
     retrieve( calib_label[ 0 ], 321, 81 );
 }
 
+void CalibrationData::encode()
+{
+    store( offset, 0 );
+    store( factor, 8 );
+    store( current_unit, 16 );
+    store( string, 18, 40 );
+    store( calib_valid, 98 );
+    store( input_unit, 99 );
+    store( polynom_unit, 100 );
+    store( polynom_order, 101 );
+    store( calib_count, 102 );
+    store( pixel_position, 103, 80 );
+    store( calib_value, 183, 80 );
+    store( polynom_coeff, 263, 48 );
+    store( laser_position, 311 );
+    store( new_calib_flag, 320 );
+    store( calib_label, 321, 81 );
+}
+
 void CalibrationData::reset()
 {
     Data::reset();
@@ -0,0 +1,217 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cstring>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#define SPE_CONVERT_X86
+#endif
+
+#include "convert.h"
+
+namespace SPE {
+namespace {
+// Side of the square blocks used to transpose frames, sized so a block of floats fits in L1 cache
+const std::size_t BLOCK = 64;
+
+template<class T> void convertScalar( const T* pixels, float* values, const std::size_t count )
+{
+    for ( std::size_t index = 0; index < count; ++index ) values[ index ] = pixels[ index ];
+}
+
+#ifdef SPE_CONVERT_X86
+void convertSSE2( const std::int32_t* pixels, float* values, const std::size_t count )
+{
+    std::size_t index = 0;
+    for ( ; index + 4 <= count; index += 4 ) {
+        const auto integers = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + index ) );
+        _mm_storeu_ps( values + index, _mm_cvtepi32_ps( integers ) );
+    }
+    convertScalar( pixels + index, values + index, count - index );
+}
+
+void convertSSE2( const std::int16_t* pixels, float* values, const std::size_t count )
+{
+    std::size_t index = 0;
+    for ( ; index + 8 <= count; index += 8 ) {
+        const auto shorts = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + index ) );
+
+        // Place each short in the upper half of an integer and shift it back down to extend the sign
+        const auto low = _mm_srai_epi32( _mm_unpacklo_epi16( shorts, shorts ), 16 );
+        const auto high = _mm_srai_epi32( _mm_unpackhi_epi16( shorts, shorts ), 16 );
+        _mm_storeu_ps( values + index, _mm_cvtepi32_ps( low ) );
+        _mm_storeu_ps( values + index + 4, _mm_cvtepi32_ps( high ) );
+    }
+    convertScalar( pixels + index, values + index, count - index );
+}
+
+void convertSSE2( const std::uint16_t* pixels, float* values, const std::size_t count )
+{
+    const auto zero = _mm_setzero_si128();
+
+    std::size_t index = 0;
+    for ( ; index + 8 <= count; index += 8 ) {
+        const auto shorts = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + index ) );
+        const auto low = _mm_unpacklo_epi16( shorts, zero );
+        const auto high = _mm_unpackhi_epi16( shorts, zero );
+        _mm_storeu_ps( values + index, _mm_cvtepi32_ps( low ) );
+        _mm_storeu_ps( values + index + 4, _mm_cvtepi32_ps( high ) );
+    }
+    convertScalar( pixels + index, values + index, count - index );
+}
+
+__attribute__(( target( "avx2" ) )) void convertAVX2( const std::int32_t* pixels, float* values, const std::size_t count )
+{
+    std::size_t index = 0;
+    for ( ; index + 8 <= count; index += 8 ) {
+        const auto integers = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( pixels + index ) );
+        _mm256_storeu_ps( values + index, _mm256_cvtepi32_ps( integers ) );
+    }
+    convertScalar( pixels + index, values + index, count - index );
+}
+
+__attribute__(( target( "avx2" ) )) void convertAVX2( const std::int16_t* pixels, float* values, const std::size_t count )
+{
+    std::size_t index = 0;
+    for ( ; index + 8 <= count; index += 8 ) {
+        const auto shorts = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + index ) );
+        _mm256_storeu_ps( values + index, _mm256_cvtepi32_ps( _mm256_cvtepi16_epi32( shorts ) ) );
+    }
+    convertScalar( pixels + index, values + index, count - index );
+}
+
+__attribute__(( target( "avx2" ) )) void convertAVX2( const std::uint16_t* pixels, float* values, const std::size_t count )
+{
+    std::size_t index = 0;
+    for ( ; index + 8 <= count; index += 8 ) {
+        const auto shorts = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + index ) );
+        _mm256_storeu_ps( values + index, _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( shorts ) ) );
+    }
+    convertScalar( pixels + index, values + index, count - index );
+}
+#endif
+
+enum class Instructions { SCALAR, SSE2, AVX2 };
+
+// Choose the widest instructions supported by the processor, once
+Instructions instructions()
+{
+#ifdef SPE_CONVERT_X86
+    static const auto INSTRUCTIONS = __builtin_cpu_supports( "avx2" ) ? Instructions::AVX2 : ( __builtin_cpu_supports( "sse2" ) ? Instructions::SSE2 : Instructions::SCALAR );
+#else
+    static const auto INSTRUCTIONS = Instructions::SCALAR;
+#endif
+    return INSTRUCTIONS;
+}
+
+template<class T> void convert( const T* pixels, float* values, const std::size_t count )
+{
+    switch ( instructions() ) {
+#ifdef SPE_CONVERT_X86
+        case Instructions::AVX2:
+            return convertAVX2( pixels, values, count );
+        case Instructions::SSE2:
+            return convertSSE2( pixels, values, count );
+#endif
+        default:
+            return convertScalar( pixels, values, count );
+    }
+}
+
+template<class T> void convertTransposed( const T* pixels, float* values, const std::size_t rows, const std::size_t cols )
+{
+    // Row-major and column-major layouts are the same for a single row or column
+    if ( rows == 1 or cols == 1 ) return convertPixels( pixels, values, rows * cols );
+
+    float block[ BLOCK ][ BLOCK ];
+
+    for ( std::size_t row0 = 0; row0 < rows; row0 += BLOCK ) {
+        const auto blockRows = std::min( BLOCK, rows - row0 );
+
+        for ( std::size_t col0 = 0; col0 < cols; col0 += BLOCK ) {
+            const auto blockCols = std::min( BLOCK, cols - col0 );
+
+            for ( std::size_t row = 0; row < blockRows; ++row ) {
+                convertPixels( pixels + ( ( row0 + row ) * cols ) + col0, block[ row ], blockCols );
+            }
+
+            for ( std::size_t col = 0; col < blockCols; ++col ) {
+                auto column = values + ( ( col0 + col ) * rows ) + row0;
+                for ( std::size_t row = 0; row < blockRows; ++row ) column[ row ] = block[ row ][ col ];
+            }
+        }
+    }
+}
+}
+
+void convertPixels( const float* pixels, float* values, const std::size_t count )
+{
+    std::memcpy( values, pixels, count * sizeof( float ) );
+}
+
+void convertPixels( const std::int32_t* pixels, float* values, const std::size_t count )
+{
+    convert( pixels, values, count );
+}
+
+void convertPixels( const std::int16_t* pixels, float* values, const std::size_t count )
+{
+    convert( pixels, values, count );
+}
+
+void convertPixels( const std::uint16_t* pixels, float* values, const std::size_t count )
+{
+    convert( pixels, values, count );
+}
+
+void convertFrame( const float* pixels, float* values, const std::size_t rows, const std::size_t cols )
+{
+    convertTransposed( pixels, values, rows, cols );
+}
+
+void convertFrame( const std::int32_t* pixels, float* values, const std::size_t rows, const std::size_t cols )
+{
+    convertTransposed( pixels, values, rows, cols );
+}
+
+void convertFrame( const std::int16_t* pixels, float* values, const std::size_t rows, const std::size_t cols )
+{
+    convertTransposed( pixels, values, rows, cols );
+}
+
+void convertFrame( const std::uint16_t* pixels, float* values, const std::size_t rows, const std::size_t cols )
+{
+    convertTransposed( pixels, values, rows, cols );
+}
+
+/*!
+ * \return The name of the vector instructions used for conversion
+ */
+const char* conversionInstructions()
+{
+    switch ( instructions() ) {
+        case Instructions::AVX2:
+            return "AVX2";
+        case Instructions::SSE2:
+            return "SSE2";
+        default:
+            return "scalar";
+    }
+}
+}
@@ -15,6 +15,10 @@
 // You should have received a copy of the GNU General Public License
 // along with libSPE. If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <stdexcept>
+#include <unistd.h>
+
 #include "data.h"
 
 namespace SPE {
@@ -25,6 +29,18 @@ namespace SPE {
 Data::Data( const std::size_t fileOffset, const std::size_t dataLength ) : FILE_OFFSET( fileOffset ), DATA_LENGTH( dataLength ), stream( dataLength, 0 )
 {}
 
+/*!
+ * \param data The data to copy the stored bytes from
+ * \return This instance of data
+ */
+Data& Data::operator=( const Data& data )
+{
+    if ( DATA_LENGTH != data.DATA_LENGTH ) throw std::out_of_range( "Data does not have the same length as the given data." );
+
+    stream = data.stream;
+    return *this;
+}
+
 /*!
  * \param file The file stream to read data from
  * \return void
@@ -36,9 +52,80 @@ void Data::read( std::ifstream& file )
     file.read( stream.data(), DATA_LENGTH );
 }
 
+/*!
+ * \param data The data to extract binary data from
+ * \return void
+ */
+void Data::read( const Data& data )
+{
+    if ( FILE_OFFSET < data.FILE_OFFSET or FILE_OFFSET + DATA_LENGTH > data.FILE_OFFSET + data.DATA_LENGTH ) throw std::out_of_range( "Data is not contained in the given data." );
+
+    reset();
+    std::copy_n( data.stream.begin() + ( FILE_OFFSET - data.FILE_OFFSET ), DATA_LENGTH, stream.begin() );
+}
+
+/*!
+ * \param fileDescriptor The file descriptor to read data from
+ * \return void
+ */
+void Data::read( const int fileDescriptor )
+{
+    reset();
+
+    // Discard incomplete data, so that a short read leaves the data empty
+    const auto bytesRead = pread( fileDescriptor, stream.data(), DATA_LENGTH, FILE_OFFSET );
+    if ( bytesRead != static_cast<ssize_t>( DATA_LENGTH ) ) reset();
+}
+
+/*!
+ * \param value The string to store
+ * \param BYTE_OFFSET The start of the string in the binary stream
+ * \param DATA_LENGTH The length of the binary stream to convert the string into
+ * \return void
+ */
+void Data::store( const std::string& value, const std::size_t BYTE_OFFSET, const std::size_t DATA_LENGTH )
+{
+    const auto VALUE_LENGTH = std::min( DATA_LENGTH, value.size() );
+
+    std::copy_n( value.begin(), VALUE_LENGTH, stream.begin() + BYTE_OFFSET );
+    std::fill( stream.begin() + BYTE_OFFSET + VALUE_LENGTH, stream.begin() + BYTE_OFFSET + DATA_LENGTH, 0 );
+}
+
+/*!
+ * \param file The file stream to write data to
+ * \return void
+ */
+void Data::write( std::ostream& file )
+{
+    file.seekp( FILE_OFFSET );
+    file.write( stream.data(), DATA_LENGTH );
+}
+
+/*!
+ * \param fileDescriptor The file descriptor to write data to
+ * \return void
+ */
+void Data::write( const int fileDescriptor )
+{
+    const auto bytesWritten = pwrite( fileDescriptor, stream.data(), DATA_LENGTH, FILE_OFFSET );
+    if ( bytesWritten != static_cast<ssize_t>( DATA_LENGTH ) ) throw std::runtime_error( "Data could not be written." );
+}
+
+/*!
+ * \param data The data to write binary data into
+ * \return void
+ */
+void Data::write( Data& data )
+{
+    if ( FILE_OFFSET < data.FILE_OFFSET or FILE_OFFSET + DATA_LENGTH > data.FILE_OFFSET + data.DATA_LENGTH ) throw std::out_of_range( "Data is not contained in the given data." );
+
+    std::copy_n( stream.begin(), DATA_LENGTH, data.stream.begin() + ( FILE_OFFSET - data.FILE_OFFSET ) );
+}
+
 void Data::reset()
 {
-    stream.clear();
+    // Keep the buffer at its full length so that retrieve() always reads from valid memory
+    std::fill( stream.begin(), stream.end(), 0 );
 }
 }
 
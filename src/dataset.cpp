@@ -0,0 +1,284 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <dirent.h>
+#include <fnmatch.h>
+
+#include "dataset.h"
+#include "reduction.h"
+
+namespace SPE {
+/*!
+ * \param filePaths The paths to the SPE files, in the order of their frames
+ * \param threads The number of threads to use, 0 to use one per core
+ * \param lazy Whether to load the metadata of each file lazily
+ */
+Dataset::Dataset( const std::vector<std::string>& filePaths, const unsigned threads, const bool lazy ) : threads( threads ? threads : std::max( std::thread::hardware_concurrency(), 1u ) )
+{
+    open( filePaths, lazy );
+}
+
+/*!
+ * \param directory The path to a directory
+ * \return The paths to the SPE files in the directory, in alphabetical order
+ */
+std::vector<std::string> Dataset::findFiles( const std::string& directory )
+{
+    struct dirent** entries = nullptr;
+    auto filter = []( const struct dirent* entry ) { return fnmatch( "*.spe", entry->d_name, FNM_CASEFOLD ) == 0 ? 1 : 0; };
+    const int numEntries = scandir( directory.c_str(), &entries, filter, alphasort );
+    if ( numEntries < 0 ) throw std::runtime_error( "Directory " + directory + " could not be read." );
+
+    const std::string prefix = ( directory.empty() or directory.back() == '/' ) ? directory : directory + "/";
+    std::vector<std::string> filePaths;
+    for ( int entry = 0; entry < numEntries; ++entry ) {
+        filePaths.push_back( prefix + entries[ entry ]->d_name );
+        free( entries[ entry ] );
+    }
+    free( entries );
+
+    return filePaths;
+}
+
+/*!
+ * \return The number of files in the dataset
+ */
+std::size_t Dataset::files() const
+{
+    return m_files.size();
+}
+
+/*!
+ * \param index The index of the file in the dataset, starts at 0
+ * \return The file
+ */
+File& Dataset::file( const std::size_t index )
+{
+    if ( index >= m_files.size() ) throw std::out_of_range( "File does not exist in the dataset." );
+
+    return *m_files[ index ];
+}
+
+/*!
+ * \param frame The global index of the frame, starts at 0
+ * \return The index of the file and the index of the frame in that file
+ */
+std::pair<std::size_t, long> Dataset::locate( const std::size_t frame ) const
+{
+    if ( frame >= frames() ) throw std::out_of_range( "Frame does not exist in the dataset." );
+
+    const std::size_t index = std::upper_bound( firstFrames.begin(), firstFrames.end(), frame ) - firstFrames.begin() - 1;
+    return std::make_pair( index, static_cast<long>( frame - firstFrames[ index ] ) );
+}
+
+/*!
+ * \param row The row of the pixel, starts at 0
+ * \param column The column of the pixel, starts at 0
+ * \param frame The global index of the frame, starts at 0
+ * \return The intensity of the pixel
+ */
+float Dataset::getPixel( const unsigned short row, const unsigned short column, const std::size_t frame )
+{
+    const auto location = locate( frame );
+    return m_files[ location.first ]->getPixel( row, column, location.second );
+}
+
+/*!
+ * \param frame The global index of the frame, starts at 0
+ * \return The frame
+ */
+Eigen::ArrayXXf Dataset::getFrame( const std::size_t frame )
+{
+    const auto location = locate( frame );
+    return m_files[ location.first ]->getFrame( location.second );
+}
+
+/*!
+ * \param first The global index of the first frame to fetch, starts at 0
+ * \param count The number of frames to fetch
+ * \param stride The number of frames to step from one fetched frame to the next
+ * \return A stack of the fetched frames, in the order of their global index
+ */
+FrameStack Dataset::getFrames( const std::size_t first, const std::size_t count, const std::size_t stride )
+{
+    if ( stride < 1 ) throw std::out_of_range( "Invalid range of frames." );
+    if ( count > 0 and first + ( ( count - 1 ) * stride ) >= frames() ) throw std::out_of_range( "Frame does not exist in the dataset." );
+
+    FrameStack stack( count, rows(), columns() );
+    const std::size_t frameDim = rows() * columns();
+
+    // Fetch the frames of each file in one go
+    for ( std::size_t frame = 0; frame < count; ) {
+        const auto location = locate( first + ( frame * stride ) );
+        const std::size_t remaining = m_files[ location.first ]->frames() - location.second;
+        const std::size_t fileCount = std::min( count - frame, ( ( remaining - 1 ) / stride ) + 1 );
+
+        const auto fileStack = m_files[ location.first ]->getFrames( location.second, fileCount, stride );
+        std::memcpy( stack.data() + ( frame * frameDim ), fileStack.data(), sizeof( float ) * fileStack.size() );
+        frame += fileCount;
+    }
+
+    return stack;
+}
+
+/*!
+ * \return The average frame
+ */
+Eigen::ArrayXXf Dataset::getAverageFrame()
+{
+    if ( frames() == 0 ) return Eigen::ArrayXXf::Zero( rows(), columns() );
+
+    switch ( m_files.front()->metadata.datatype() ) {
+        case 0:
+            return getAverageFrameArray<float>();
+        case 1:
+            return getAverageFrameArray<std::int32_t>();
+        case 2:
+            return getAverageFrameArray<std::int16_t>();
+        case 3:
+            return getAverageFrameArray<std::uint16_t>();
+    }
+
+    return Eigen::ArrayXXf();
+}
+
+/*!
+ * \param quantities The statistics to calculate, a bitwise or of Statistics::Quantity values
+ * \param memoryBudget The approximate number of bytes of working memory to use
+ * \return The requested statistics
+ */
+Statistics Dataset::getStatistics( const unsigned quantities, const std::size_t memoryBudget )
+{
+    Statistics statistics;
+    if ( frames() == 0 ) return statistics;
+
+    switch ( m_files.front()->metadata.datatype() ) {
+        case 0:
+            statistics = getStatisticsArrays<float>( quantities, memoryBudget );
+            break;
+        case 1:
+            statistics = getStatisticsArrays<std::int32_t>( quantities, memoryBudget );
+            break;
+        case 2:
+            statistics = getStatisticsArrays<std::int16_t>( quantities, memoryBudget );
+            break;
+        case 3:
+            statistics = getStatisticsArrays<std::uint16_t>( quantities, memoryBudget );
+            break;
+    }
+
+    return statistics;
+}
+
+/*!
+ * \return The number of rows in each frame
+ */
+std::size_t Dataset::rows() const
+{
+    return m_files.empty() ? 0 : m_files.front()->rows();
+}
+
+/*!
+ * \return The number of columns in each frame
+ */
+std::size_t Dataset::columns() const
+{
+    return m_files.empty() ? 0 : m_files.front()->columns();
+}
+
+/*!
+ * \return The number of frames in all files together
+ */
+std::size_t Dataset::frames() const
+{
+    return firstFrames.empty() ? 0 : firstFrames.back();
+}
+
+/*!
+ * \param filePaths The paths to the SPE files, in the order of their frames
+ * \param lazy Whether to load the metadata of each file lazily
+ */
+void Dataset::open( const std::vector<std::string>& filePaths, const bool lazy )
+{
+    m_files.resize( filePaths.size() );
+
+    const std::size_t workers = std::max<std::size_t>( std::min<std::size_t>( threads, filePaths.size() ), 1 );
+    std::vector<std::exception_ptr> errors( filePaths.size() );
+    std::atomic<std::size_t> nextFile( 0 );
+
+    auto openFiles = [&]() {
+        for ( auto index = nextFile++; index < filePaths.size(); index = nextFile++ ) {
+            try {
+                m_files[ index ].reset( new File( filePaths[ index ], lazy ) );
+            } catch ( ... ) {
+                errors[ index ] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for ( std::size_t worker = 1; worker < workers; ++worker ) pool.emplace_back( openFiles );
+    openFiles();
+    for ( auto& thread : pool ) thread.join();
+    for ( auto& error : errors ) if ( error ) std::rethrow_exception( error );
+
+    // Check that all files can be read as one
+    firstFrames.assign( 1, 0 );
+    for ( std::size_t index = 0; index < m_files.size(); ++index ) {
+        File& file = *m_files[ index ];
+        if ( file.rows() != rows() or file.columns() != columns() ) throw std::runtime_error( "File " + filePaths[ index ] + " has a different frame size than " + filePaths.front() + "." );
+        if ( file.metadata.datatype() != m_files.front()->metadata.datatype() ) throw std::runtime_error( "File " + filePaths[ index ] + " has a different datatype than " + filePaths.front() + "." );
+
+        firstFrames.push_back( firstFrames.back() + file.frames() );
+    }
+}
+
+template<class T> PixelReader<T> Dataset::pixelReader() const
+{
+    return [this]( const std::size_t frame, const std::size_t first, const std::size_t count, T* buffer ) {
+        const auto location = locate( frame );
+        return m_files[ location.first ]->readPixels( location.second, first, count, buffer );
+    };
+}
+
+template<class T> Eigen::ArrayXXf Dataset::getAverageFrameArray() const
+{
+    // Sum this many frames at a time; blocks never span two files
+    const std::size_t blockSize = 32;
+
+    std::vector<std::pair<std::size_t, std::size_t>> blocks;
+    for ( std::size_t index = 0; index < m_files.size(); ++index ) {
+        const std::size_t fileFrames = m_files[ index ]->frames();
+        for ( std::size_t frame = 0; frame < fileFrames; frame += blockSize ) blocks.push_back( std::make_pair( firstFrames[ index ] + frame, std::min( blockSize, fileFrames - frame ) ) );
+    }
+
+    return averageFrames<T>( rows(), columns(), blocks, threads, pixelReader<T>() );
+}
+
+template<class T> Statistics Dataset::getStatisticsArrays( const unsigned quantities, const std::size_t memoryBudget ) const
+{
+    return frameStatistics<T>( rows(), columns(), frames(), quantities, memoryBudget, threads, pixelReader<T>() );
+}
+}
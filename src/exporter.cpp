@@ -0,0 +1,190 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "exporter.h"
+#include "spe.h"
+
+namespace SPE {
+// The .npy header is padded to this size, so it can be rewritten in place with a larger number of frames
+const std::size_t NPY_HEADER_SIZE = 128;
+
+// Read this many bytes of frames at a time when exporting from an SPE file
+const std::size_t CHUNK_SIZE = 16 << 20;
+
+/*!
+ * \param path The path to the file to write
+ * \param rows The number of rows in each frame
+ * \param columns The number of columns in each frame
+ * \param format The format of the file
+ */
+Exporter::Exporter( const std::string& path, const std::size_t rows, const std::size_t columns, const Format format ) : Exporter( path, rows, columns, format, true )
+{}
+
+/*!
+ * \param path The path to the file to write
+ * \param rows The number of rows in each frame
+ * \param columns The number of columns in each frame
+ * \param format The format of the file
+ * \param stack Whether the file holds a stack of frames or a single frame
+ */
+Exporter::Exporter( const std::string& path, const std::size_t rows, const std::size_t columns, const Format format, const bool stack ) : path( path ), m_rows( rows ), m_columns( columns ), format( format ), stack( stack )
+{
+    fileDescriptor = ::open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 );
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + path + " could not be opened." );
+
+    // Reserve the header; it is rewritten with the final number of frames on close
+    if ( format == NPY ) {
+        const auto npyHeader = header();
+        append( npyHeader.data(), npyHeader.size() );
+    }
+}
+
+Exporter::~Exporter()
+{
+    try {
+        close();
+    } catch ( ... ) {
+    }
+}
+
+/*!
+ * \param frame The frame to append
+ */
+void Exporter::write( const Eigen::Ref<const Eigen::ArrayXXf>& frame )
+{
+    if ( std::size_t( frame.rows() ) != m_rows or std::size_t( frame.cols() ) != m_columns ) throw std::runtime_error( "Frame does not match the size of the frames in " + path + "." );
+
+    const RowMajorArrayXXf rowMajorFrame = frame;
+    append( reinterpret_cast<const char*>( rowMajorFrame.data() ), sizeof( float ) * rowMajorFrame.size() );
+    ++m_frames;
+}
+
+/*!
+ * \param frames The stack of frames to append
+ */
+void Exporter::write( const FrameStack& frames )
+{
+    if ( frames.frames() == 0 ) return;
+    if ( frames.rows() != m_rows or frames.columns() != m_columns ) throw std::runtime_error( "Frame does not match the size of the frames in " + path + "." );
+
+    append( reinterpret_cast<const char*>( frames.data() ), sizeof( float ) * frames.size() );
+    m_frames += frames.frames();
+}
+
+/*!
+ * \param file The SPE file to read the frames from
+ * \param first The index of the first frame to append, starts at 0
+ * \param count The number of frames to append
+ */
+void Exporter::write( File& file, const long first, const long count )
+{
+    const long chunkFrames = std::max<long>( CHUNK_SIZE / std::max<std::size_t>( sizeof( float ) * m_rows * m_columns, 1 ), 1 );
+    for ( long chunk = 0; chunk < count; chunk += chunkFrames ) write( file.getFrames( first + chunk, std::min( chunkFrames, count - chunk ) ) );
+}
+
+void Exporter::close()
+{
+    if ( fileDescriptor < 0 ) return;
+
+    const int descriptor = fileDescriptor;
+    fileDescriptor = -1;
+
+    bool failed = false;
+    if ( format == NPY ) {
+        const auto npyHeader = header();
+        failed = pwrite( descriptor, npyHeader.data(), npyHeader.size(), 0 ) != static_cast<ssize_t>( npyHeader.size() );
+    }
+    if ( ::close( descriptor ) != 0 ) failed = true;
+
+    if ( failed ) throw std::runtime_error( "File " + path + " could not be written." );
+}
+
+/*!
+ * \return The number of frames written so far
+ */
+std::size_t Exporter::frames() const
+{
+    return m_frames;
+}
+
+/*!
+ * \param path The path to the file to write
+ * \param frame The frame to save
+ * \param format The format of the file
+ */
+void Exporter::save( const std::string& path, const Eigen::Ref<const Eigen::ArrayXXf>& frame, const Format format )
+{
+    Exporter exporter( path, frame.rows(), frame.cols(), format, false );
+    exporter.write( frame );
+    exporter.close();
+}
+
+/*!
+ * \param path The path to the file to write
+ * \param frames The stack of frames to save
+ * \param format The format of the file
+ */
+void Exporter::save( const std::string& path, const FrameStack& frames, const Format format )
+{
+    Exporter exporter( path, frames.rows(), frames.columns(), format );
+    exporter.write( frames );
+    exporter.close();
+}
+
+/*!
+ * \param data The bytes to append
+ * \param size The number of bytes to append
+ */
+void Exporter::append( const char* data, std::size_t size )
+{
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + path + " is already closed." );
+
+    while ( size > 0 ) {
+        const auto written = ::write( fileDescriptor, data, size );
+        if ( written < 0 and errno == EINTR ) continue;
+        if ( written <= 0 ) throw std::runtime_error( "File " + path + " could not be written." );
+
+        data += written;
+        size -= written;
+    }
+}
+
+/*!
+ * \return The .npy header for the frames written so far, padded to its fixed size
+ */
+std::string Exporter::header() const
+{
+    std::string shape = stack ? std::to_string( m_frames ) + ", " : "";
+    shape += std::to_string( m_rows ) + ", " + std::to_string( m_columns );
+
+    std::string dictionary = "{'descr': '<f4', 'fortran_order': False, 'shape': (" + shape + "), }";
+    dictionary.resize( NPY_HEADER_SIZE - 10 - 1, ' ' );
+    dictionary += '\n';
+
+    // Magic string, version 1.0 and the little-endian length of the dictionary
+    std::string npyHeader( "\x93NUMPY\x01\x00", 8 );
+    npyHeader += static_cast<char>( dictionary.size() & 0xff );
+    npyHeader += static_cast<char>( dictionary.size() >> 8 );
+    return npyHeader + dictionary;
+}
+}
@@ -0,0 +1,140 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include "frameCache.h"
+
+namespace SPE {
+//! \param budget The most memory, in bytes, the cached frames may take up
+FrameCache::FrameCache( const std::size_t budget ) : m_budget( budget )
+{}
+
+/*!
+ * \param frame The index of the frame, starts at 0
+ * \return The cached frame, or a null pointer
+ */
+std::shared_ptr<const Eigen::ArrayXXf> FrameCache::find( const long frame )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    if ( m_budget == 0 ) return nullptr;
+
+    const auto entry = index.find( frame );
+    if ( entry == index.end() ) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    entries.splice( entries.begin(), entries, entry->second );
+    return entry->second->second;
+}
+
+/*!
+ * \param frame The index of the frame, starts at 0
+ * \param frameArray The decoded frame
+ */
+void FrameCache::insert( const long frame, const std::shared_ptr<const Eigen::ArrayXXf>& frameArray )
+{
+    const std::size_t frameSize = sizeof( float ) * frameArray->size();
+
+    std::lock_guard<std::mutex> lock( mutex );
+    if ( m_budget == 0 or frameSize > m_budget ) return;
+
+    const auto entry = index.find( frame );
+    if ( entry != index.end() ) {
+        m_size -= sizeof( float ) * entry->second->second->size();
+        entries.erase( entry->second );
+    }
+
+    entries.emplace_front( frame, frameArray );
+    index[ frame ] = entries.begin();
+    m_size += frameSize;
+
+    evict();
+}
+
+void FrameCache::clear()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    entries.clear();
+    index.clear();
+    m_size = 0;
+    m_hits = 0;
+    m_misses = 0;
+}
+
+//! \param budget The most memory, in bytes, the cached frames may take up
+void FrameCache::setBudget( const std::size_t budget )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    m_budget = budget;
+    evict();
+}
+
+/*!
+ * \return The most memory, in bytes, the cached frames may take up
+ */
+std::size_t FrameCache::budget() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return m_budget;
+}
+
+/*!
+ * \return The memory, in bytes, taken up by the cached frames
+ */
+std::size_t FrameCache::size() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return m_size;
+}
+
+/*!
+ * \return The number of frames found in the cache
+ */
+std::size_t FrameCache::hits() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return m_hits;
+}
+
+/*!
+ * \return The number of frames not found in the cache
+ */
+std::size_t FrameCache::misses() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return m_misses;
+}
+
+/*!
+ * \return Whether the cache is enabled
+ */
+bool FrameCache::enabled() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return m_budget > 0;
+}
+
+void FrameCache::evict()
+{
+    while ( m_size > m_budget ) {
+        m_size -= sizeof( float ) * entries.back().second->size();
+        index.erase( entries.back().first );
+        entries.pop_back();
+    }
+}
+}
@@ -0,0 +1,100 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <stdexcept>
+
+#include "frameStack.h"
+
+namespace SPE {
+/*!
+ * \param frames The number of frames in the stack
+ * \param rows The number of rows in each frame
+ * \param columns The number of columns in each frame
+ */
+FrameStack::FrameStack( const std::size_t frames, const std::size_t rows, const std::size_t columns ) : m_frames( frames ), m_rows( rows ), m_columns( columns ), values( frames * rows * columns, 0.0 )
+{}
+
+/*!
+ * \param frame The index of the frame in the stack, starts at 0
+ * \return A view of the frame
+ */
+FrameStack::FrameView FrameStack::frame( const std::size_t frame )
+{
+    if ( frame >= m_frames ) throw std::out_of_range( "Frame does not exist in the stack." );
+
+    return FrameView( values.data() + ( frame * m_rows * m_columns ), m_rows, m_columns );
+}
+
+/*!
+ * \param frame The index of the frame in the stack, starts at 0
+ * \return A read-only view of the frame
+ */
+FrameStack::ConstFrameView FrameStack::frame( const std::size_t frame ) const
+{
+    if ( frame >= m_frames ) throw std::out_of_range( "Frame does not exist in the stack." );
+
+    return ConstFrameView( values.data() + ( frame * m_rows * m_columns ), m_rows, m_columns );
+}
+
+/*!
+ * \return The number of frames in the stack
+ */
+std::size_t FrameStack::frames() const
+{
+    return m_frames;
+}
+
+/*!
+ * \return The number of rows in each frame
+ */
+std::size_t FrameStack::rows() const
+{
+    return m_rows;
+}
+
+/*!
+ * \return The number of columns in each frame
+ */
+std::size_t FrameStack::columns() const
+{
+    return m_columns;
+}
+
+/*!
+ * \return The number of values in the stack
+ */
+std::size_t FrameStack::size() const
+{
+    return values.size();
+}
+
+/*!
+ * \return A pointer to the first value of the stack
+ */
+float* FrameStack::data()
+{
+    return values.data();
+}
+
+/*!
+ * \return A pointer to the first value of the stack
+ */
+const float* FrameStack::data() const
+{
+    return values.data();
+}
+}
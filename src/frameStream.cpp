@@ -0,0 +1,205 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <cstdint>
+#include <stdexcept>
+
+#include "frameStream.h"
+#include "spe.h"
+#include "convert.h"
+#include "datatype.h"
+#include "offsets.h"
+
+namespace SPE {
+/*!
+ * \param stream The stream being iterated over
+ * \param frame The index of the frame the iterator refers to, starts at 0
+ */
+FrameStream::Iterator::Iterator( FrameStream* stream, const std::size_t frame ) : stream( stream ), frame( frame )
+{}
+
+/*!
+ * \return The current frame of the stream
+ */
+const Eigen::ArrayXXf& FrameStream::Iterator::operator*() const
+{
+    return stream->current;
+}
+
+/*!
+ * \return A pointer to the current frame of the stream
+ */
+const Eigen::ArrayXXf* FrameStream::Iterator::operator->() const
+{
+    return &stream->current;
+}
+
+/*!
+ * \return The iterator, now referring to the next frame of the stream
+ */
+FrameStream::Iterator& FrameStream::Iterator::operator++()
+{
+    ++frame;
+    if ( frame < stream->frames ) stream->next();
+    return *this;
+}
+
+/*!
+ * \param other The iterator to compare to
+ * \return Whether both iterators refer to the same frame
+ */
+bool FrameStream::Iterator::operator==( const Iterator& other ) const
+{
+    return frame == other.frame;
+}
+
+/*!
+ * \param other The iterator to compare to
+ * \return Whether the iterators refer to different frames
+ */
+bool FrameStream::Iterator::operator!=( const Iterator& other ) const
+{
+    return frame != other.frame;
+}
+
+/*!
+ * \param file The SPE file to stream frames from
+ * \param depth The number of frames to read ahead of the current one
+ */
+FrameStream::FrameStream( const File& file, const std::size_t depth ) : file( file ), mapping( file.mapping ), mappingSize( file.mappingSize ), rows( file.rows() ), columns( file.columns() ), frames( file.frames() ), datatype( file.metadata.datatype() )
+{
+    if ( pixelSize( datatype ) == 0 ) throw std::runtime_error( "Unknown datatype of the file." );
+
+    // The current frame holds one buffer while the reader fills the others
+    for ( std::size_t buffer = 0; buffer < depth + 1; ++buffer ) {
+        pool.emplace_back( rows, columns );
+    }
+}
+
+FrameStream::~FrameStream()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopped = true;
+    }
+    bufferFree.notify_all();
+    if ( reader.joinable() ) reader.join();
+}
+
+/*!
+ * \return An iterator to the first frame of the stream
+ */
+FrameStream::Iterator FrameStream::begin()
+{
+    if ( started ) throw std::runtime_error( "Frame stream has already been iterated over." );
+    started = true;
+
+    if ( frames == 0 ) return end();
+
+    reader = std::thread( &FrameStream::readAhead, this );
+    next();
+
+    return Iterator( this, 0 );
+}
+
+/*!
+ * \return An iterator past the last frame of the stream
+ */
+FrameStream::Iterator FrameStream::end()
+{
+    return Iterator( this, frames );
+}
+
+void FrameStream::next()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+
+    // Hand the finished frame back to the reader to be filled again
+    if ( holding ) {
+        pool.push_back( std::move( current ) );
+        holding = false;
+        bufferFree.notify_one();
+    }
+
+    frameReady.wait( lock, [this] { return not queue.empty() or error; } );
+    if ( queue.empty() ) std::rethrow_exception( error );
+
+    current = std::move( queue.front() );
+    queue.pop_front();
+    holding = true;
+}
+
+void FrameStream::readAhead()
+{
+    try {
+        switch ( datatype ) {
+            case 0:
+                readFrames<float>();
+                break;
+            case 1:
+                readFrames<std::int32_t>();
+                break;
+            case 2:
+                readFrames<std::int16_t>();
+                break;
+            case 3:
+                readFrames<std::uint16_t>();
+                break;
+        }
+    } catch ( ... ) {
+        std::lock_guard<std::mutex> lock( mutex );
+        error = std::current_exception();
+    }
+
+    frameReady.notify_one();
+}
+
+template<class T> void FrameStream::readFrames()
+{
+    const std::size_t frameDim = rows * columns;
+    const std::size_t frameSize = sizeof( T ) * frameDim;
+    std::vector<T> pixels( mapping ? 0 : frameDim );
+
+    for ( std::size_t frame = 0; frame < frames; ++frame ) {
+        Eigen::ArrayXXf buffer;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            bufferFree.wait( lock, [this] { return not pool.empty() or stopped; } );
+            if ( stopped ) break;
+            buffer = std::move( pool.back() );
+            pool.pop_back();
+        }
+
+        const std::size_t offset = OFFSET_DATA + ( frameSize * frame );
+        const T* source = pixels.data();
+        if ( mapping ) {
+            if ( offset + frameSize > mappingSize ) throw std::out_of_range( "Frame extends beyond the end of the file." );
+            source = reinterpret_cast<const T*>( mapping + offset );
+        } else {
+            file.readBytes( reinterpret_cast<char*>( pixels.data() ), frameSize, offset );
+        }
+
+        convertFrame( source, buffer.data(), rows, columns );
+
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            queue.push_back( std::move( buffer ) );
+        }
+        frameReady.notify_one();
+    }
+}
+}
@@ -0,0 +1,277 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "headerPatch.h"
+
+namespace SPE {
+namespace {
+// The journal starts with this tag and ends with a checksum of everything before it
+const char JOURNAL_TAG[] = "SPEPATCH";
+const std::size_t JOURNAL_TAG_LENGTH = 8;
+
+/*!
+ * \param path The path to the SPE file
+ * \return The path to the journal of the SPE file
+ */
+std::string journalPath( const std::string& path )
+{
+    return path + ".patch";
+}
+
+/*!
+ * \param data The bytes to check
+ * \param size The number of bytes
+ * \return The 64-bit FNV-1a hash of the bytes
+ */
+std::uint64_t checksum( const char* data, const std::size_t size )
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for ( std::size_t index = 0; index < size; ++index ) {
+        hash ^= static_cast<unsigned char>( data[ index ] );
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/*!
+ * \param fileDescriptor The file to write to
+ * \param data The bytes to write
+ * \param size The number of bytes
+ * \param offset The offset in the file to write the bytes at
+ * \return Whether all bytes were written
+ */
+bool writeAll( const int fileDescriptor, const char* data, std::size_t size, std::size_t offset )
+{
+    while ( size > 0 ) {
+        const auto written = pwrite( fileDescriptor, data, size, offset );
+        if ( written < 0 and errno == EINTR ) continue;
+        if ( written <= 0 ) return false;
+
+        data += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+/*!
+ * \param path The path to a file
+ * \return Whether the directory holding the file was flushed to disk
+ */
+bool syncDirectory( const std::string& path )
+{
+    const auto slash = path.find_last_of( '/' );
+    const std::string directory = slash == std::string::npos ? "." : ( slash == 0 ? "/" : path.substr( 0, slash ) );
+
+    const int descriptor = ::open( directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if ( descriptor < 0 ) return false;
+
+    const bool synced = fsync( descriptor ) == 0;
+    ::close( descriptor );
+    return synced;
+}
+
+/*!
+ * \param fileDescriptor The SPE file open for writing
+ * \param journal The contents of the journal
+ * \return Whether the journal was complete and its fields were written to the header
+ */
+bool replay( const int fileDescriptor, const std::vector<char>& journal )
+{
+    const std::size_t headerLength = JOURNAL_TAG_LENGTH + sizeof( std::uint32_t );
+    if ( journal.size() < headerLength + sizeof( std::uint64_t ) ) return false;
+    if ( std::memcmp( journal.data(), JOURNAL_TAG, JOURNAL_TAG_LENGTH ) != 0 ) return false;
+
+    const std::size_t end = journal.size() - sizeof( std::uint64_t );
+    std::uint64_t storedChecksum;
+    std::memcpy( &storedChecksum, journal.data() + end, sizeof( storedChecksum ) );
+    if ( storedChecksum != checksum( journal.data(), end ) ) return false;
+
+    // Check every entry before writing any of them
+    std::uint32_t count;
+    std::memcpy( &count, journal.data() + JOURNAL_TAG_LENGTH, sizeof( count ) );
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> entries;
+    std::size_t position = headerLength;
+    for ( std::uint32_t entry = 0; entry < count; ++entry ) {
+        std::uint32_t offset, length;
+        if ( position + ( 2 * sizeof( std::uint32_t ) ) > end ) return false;
+        std::memcpy( &offset, journal.data() + position, sizeof( offset ) );
+        std::memcpy( &length, journal.data() + position + sizeof( offset ), sizeof( length ) );
+        position += 2 * sizeof( std::uint32_t );
+
+        if ( position + length > end or offset + std::size_t( length ) > OFFSET_LASTVALUE ) return false;
+        entries.push_back( std::make_pair( offset, length ) );
+        position += length;
+    }
+    if ( position != end ) return false;
+
+    position = headerLength;
+    for ( auto& entry : entries ) {
+        position += 2 * sizeof( std::uint32_t );
+        if ( not writeAll( fileDescriptor, journal.data() + position, entry.second, entry.first ) ) throw std::runtime_error( "Header could not be written." );
+        position += entry.second;
+    }
+
+    if ( fdatasync( fileDescriptor ) != 0 ) throw std::runtime_error( "Header could not be written." );
+    return true;
+}
+
+/*!
+ * \param path The path to the SPE file
+ * \param fileDescriptor The SPE file open for writing
+ * \return Whether an interrupted patch was completed
+ */
+bool recoverJournal( const std::string& path, const int fileDescriptor )
+{
+    const auto journal = journalPath( path );
+    const int descriptor = ::open( journal.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( descriptor < 0 ) return false;
+
+    struct stat status;
+    std::vector<char> contents;
+    if ( fstat( descriptor, &status ) == 0 ) {
+        contents.resize( status.st_size );
+        if ( pread( descriptor, contents.data(), contents.size(), 0 ) != static_cast<ssize_t>( contents.size() ) ) contents.clear();
+    }
+    ::close( descriptor );
+
+    // An incomplete journal was never acted on, so it is simply dropped
+    const bool replayed = replay( fileDescriptor, contents );
+    unlink( journal.c_str() );
+    return replayed;
+}
+}
+
+/*!
+ * \param path The path to the SPE file to patch
+ */
+void HeaderPatch::apply( const std::string& path ) const
+{
+    const int fileDescriptor = ::open( path.c_str(), O_RDWR | O_CLOEXEC );
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + path + " could not be opened." );
+
+    try {
+        recoverJournal( path, fileDescriptor );
+
+        std::int16_t lastvalue = 0;
+        if ( pread( fileDescriptor, &lastvalue, sizeof( lastvalue ), OFFSET_LASTVALUE ) != sizeof( lastvalue ) or lastvalue != LASTVALUE ) throw std::runtime_error( "File " + path + " is not an SPE file." );
+
+        if ( not fields.empty() ) {
+            // Journal the new bytes of all fields, then write them into the header
+            std::vector<char> journal( JOURNAL_TAG, JOURNAL_TAG + JOURNAL_TAG_LENGTH );
+            auto append = [&journal]( const void* data, const std::size_t size ) {
+                journal.insert( journal.end(), static_cast<const char*>( data ), static_cast<const char*>( data ) + size );
+            };
+
+            const std::uint32_t count = fields.size();
+            append( &count, sizeof( count ) );
+            for ( auto& field : fields ) {
+                const std::uint32_t offset = field.first;
+                const std::uint32_t length = field.second.size();
+                append( &offset, sizeof( offset ) );
+                append( &length, sizeof( length ) );
+                append( field.second.data(), length );
+            }
+            const auto journalChecksum = checksum( journal.data(), journal.size() );
+            append( &journalChecksum, sizeof( journalChecksum ) );
+
+            const auto journalFile = journalPath( path );
+            const int journalDescriptor = ::open( journalFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 );
+            if ( journalDescriptor < 0 ) throw std::runtime_error( "File " + journalFile + " could not be opened." );
+
+            const bool journaled = writeAll( journalDescriptor, journal.data(), journal.size(), 0 ) and fsync( journalDescriptor ) == 0;
+            if ( ::close( journalDescriptor ) != 0 or not journaled or not syncDirectory( journalFile ) ) {
+                unlink( journalFile.c_str() );
+                throw std::runtime_error( "File " + journalFile + " could not be written." );
+            }
+
+            if ( not replay( fileDescriptor, journal ) ) throw std::runtime_error( "File " + path + " could not be patched." );
+            unlink( journalFile.c_str() );
+        }
+    } catch ( ... ) {
+        ::close( fileDescriptor );
+        throw;
+    }
+
+    if ( ::close( fileDescriptor ) != 0 ) throw std::runtime_error( "File " + path + " could not be patched." );
+}
+
+/*!
+ * \param paths The paths to the SPE files to patch, each listed once
+ * \param threads The number of threads to use, 0 to use one per core
+ */
+void HeaderPatch::apply( const std::vector<std::string>& paths, unsigned threads ) const
+{
+    if ( threads == 0 ) threads = std::max( std::thread::hardware_concurrency(), 1u );
+    threads = std::max<std::size_t>( std::min<std::size_t>( threads, paths.size() ), 1 );
+
+    std::vector<std::exception_ptr> errors( paths.size() );
+    std::atomic<std::size_t> nextFile( 0 );
+
+    auto patchFiles = [&]() {
+        for ( auto index = nextFile++; index < paths.size(); index = nextFile++ ) {
+            try {
+                apply( paths[ index ] );
+            } catch ( ... ) {
+                errors[ index ] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for ( unsigned worker = 1; worker < threads; ++worker ) pool.emplace_back( patchFiles );
+    patchFiles();
+    for ( auto& thread : pool ) thread.join();
+    for ( auto& error : errors ) if ( error ) std::rethrow_exception( error );
+}
+
+/*!
+ * \param path The path to the SPE file
+ * \return Whether an interrupted patch was completed
+ */
+bool HeaderPatch::recover( const std::string& path )
+{
+    if ( access( journalPath( path ).c_str(), F_OK ) != 0 ) return false;
+
+    const int fileDescriptor = ::open( path.c_str(), O_RDWR | O_CLOEXEC );
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + path + " could not be opened." );
+
+    bool recovered = false;
+    try {
+        recovered = recoverJournal( path, fileDescriptor );
+    } catch ( ... ) {
+        ::close( fileDescriptor );
+        throw;
+    }
+
+    ::close( fileDescriptor );
+    return recovered;
+}
+}
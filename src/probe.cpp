@@ -0,0 +1,59 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "probe.h"
+#include "data.h"
+#include "datatype.h"
+#include "offsets.h"
+
+namespace SPE {
+/*!
+ * \param filePath The path to the SPE file
+ * \return The core properties of the SPE file
+ */
+Probe probe( const std::string& filePath )
+{
+    Probe result;
+
+    const auto fileDescriptor = open( filePath.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( fileDescriptor < 0 ) return result;
+
+    Data header( 0, OFFSET_DATA );
+    header.read( fileDescriptor );
+
+    struct stat buffer;
+    const auto statFailed = fstat( fileDescriptor, &buffer );
+    close( fileDescriptor );
+    if ( statFailed ) return result;
+
+    header.retrieve( result.xdim, OFFSET_XDIM );
+    header.retrieve( result.datatype, OFFSET_DATATYPE );
+    header.retrieve( result.ydim, OFFSET_YDIM );
+    header.retrieve( result.NumFrames, OFFSET_NUMFRAMES );
+    header.retrieve( result.lastvalue, OFFSET_LASTVALUE );
+
+    const auto size = pixelSize( result.datatype );
+    const std::size_t dataSize = size * result.xdim * result.ydim * result.NumFrames;
+    result.valid = ( size > 0 ) and ( result.lastvalue == LASTVALUE ) and ( result.NumFrames >= 0 ) and ( static_cast<std::size_t>( buffer.st_size ) >= OFFSET_DATA + dataSize );
+
+    return result;
+}
+}
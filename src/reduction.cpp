@@ -0,0 +1,213 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "reduction.h"
+#include "convert.h"
+
+namespace SPE {
+template<class T> Eigen::ArrayXXf averageFrames( const std::size_t rows, const std::size_t columns, const std::vector<std::pair<std::size_t, std::size_t>>& blocks, unsigned threads, const PixelReader<T>& read )
+{
+    const std::size_t frameDim = rows * columns;
+
+    std::size_t frames = 0;
+    for ( auto& block : blocks ) frames += block.second;
+    if ( frames == 0 ) return Eigen::ArrayXXf::Zero( rows, columns );
+
+    if ( threads == 0 ) threads = std::max( std::thread::hardware_concurrency(), 1u );
+    threads = std::max<std::size_t>( std::min<std::size_t>( threads, blocks.size() ), 1 );
+
+    std::vector<double> total( frameDim, 0.0 );
+    std::vector<std::exception_ptr> errors( threads );
+    std::atomic<std::size_t> nextBlock( 0 );
+
+    // Block sums are added to the total in order of the blocks, so the result does not depend on the number of threads
+    std::mutex mutex;
+    std::condition_variable turn;
+    std::size_t combined = 0;
+    bool failed = false;
+
+    auto sumBlocks = [&]( const std::size_t worker ) {
+        try {
+            // The buffer is left uninitialized, as readers that view frames in place never touch it
+            std::unique_ptr<T[]> pixels( new T[ frameDim ] );
+            Eigen::ArrayXd sum( frameDim );
+
+            for ( auto block = nextBlock++; block < blocks.size(); block = nextBlock++ ) {
+                sum.setZero();
+
+                const std::size_t first = blocks[ block ].first;
+                const std::size_t last = first + blocks[ block ].second;
+                for ( std::size_t frame = first; frame < last; ++frame ) {
+                    const T* source = read( frame, 0, frameDim, pixels.get() );
+                    sum += Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>( source, frameDim ).template cast<double>();
+                }
+
+                std::unique_lock<std::mutex> lock( mutex );
+                turn.wait( lock, [&] { return combined == block or failed; } );
+                if ( failed ) return;
+                Eigen::Map<Eigen::ArrayXd>( total.data(), frameDim ) += sum;
+                ++combined;
+                turn.notify_all();
+            }
+        } catch ( ... ) {
+            errors.at( worker ) = std::current_exception();
+
+            // Release the threads waiting for the turn of this block
+            std::lock_guard<std::mutex> lock( mutex );
+            failed = true;
+            turn.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for ( std::size_t worker = 1; worker < threads; ++worker ) pool.emplace_back( sumBlocks, worker );
+    sumBlocks( 0 );
+    for ( auto& thread : pool ) thread.join();
+    for ( auto& error : errors ) if ( error ) std::rethrow_exception( error );
+
+    typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorArrayXXd;
+    const Eigen::Map<const RowMajorArrayXXd> totalFrame( total.data(), rows, columns );
+    return ( totalFrame / frames ).cast<float>();
+}
+
+template<class T> Statistics frameStatistics( const std::size_t rows, const std::size_t columns, const std::size_t frames, const unsigned quantities, const std::size_t memoryBudget, unsigned threads, const PixelReader<T>& read )
+{
+    const std::size_t frameDim = rows * columns;
+    const bool keepValues = quantities & Statistics::MEDIAN;
+    const std::size_t medianBlock = 64;
+
+    Statistics statistics;
+    if ( frames == 0 or frameDim == 0 ) return statistics;
+
+    if ( threads == 0 ) threads = std::max( std::thread::hardware_concurrency(), 1u );
+
+    // Size the tiles to fit the working memory of all threads in the budget, but give every thread a tile
+    const std::size_t pixelMemory = sizeof( T ) + ( 6 * sizeof( double ) ) + ( keepValues ? sizeof( float ) * frames : 0 );
+    const std::size_t medianMemory = keepValues ? sizeof( float ) * medianBlock * frames : 0;
+    std::size_t tileDim = std::max<std::size_t>( ( memoryBudget / threads ) > medianMemory ? ( ( memoryBudget / threads ) - medianMemory ) / pixelMemory : 1, 1 );
+    tileDim = std::max<std::size_t>( std::min( tileDim, ( frameDim + threads - 1 ) / threads ), 1 );
+    const std::size_t tiles = ( frameDim + tileDim - 1 ) / tileDim;
+    threads = std::max<std::size_t>( std::min<std::size_t>( threads, tiles ), 1 );
+
+    std::vector<double> mean( frameDim, 0.0 );
+    std::vector<double> variance( frameDim, 0.0 );
+    std::vector<double> minimum( frameDim, 0.0 );
+    std::vector<double> maximum( frameDim, 0.0 );
+    std::vector<double> median( frameDim, 0.0 );
+    std::vector<std::exception_ptr> errors( threads );
+    std::atomic<std::size_t> nextTile( 0 );
+
+    auto processTiles = [&]( const std::size_t worker ) {
+        try {
+            std::unique_ptr<T[]> pixels( new T[ tileDim ] );
+            std::vector<float> values( keepValues ? tileDim * frames : 0 );
+            std::vector<float> pixelValues( keepValues ? medianBlock * frames : 0 );
+            Eigen::ArrayXd x( tileDim ), delta( tileDim ), tileMean( tileDim ), tileM2( tileDim ), tileMinimum( tileDim ), tileMaximum( tileDim );
+
+            for ( auto tile = nextTile++; tile < tiles; tile = nextTile++ ) {
+                const std::size_t first = tile * tileDim;
+                const std::size_t count = std::min( tileDim, frameDim - first );
+
+                tileMean.head( count ).setZero();
+                tileM2.head( count ).setZero();
+                tileMinimum.head( count ).setConstant( std::numeric_limits<double>::infinity() );
+                tileMaximum.head( count ).setConstant( -std::numeric_limits<double>::infinity() );
+
+                for ( std::size_t frame = 0; frame < frames; ++frame ) {
+                    const T* source = read( frame, first, count, pixels.get() );
+
+                    x.head( count ) = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>( source, count ).template cast<double>();
+                    delta.head( count ) = x.head( count ) - tileMean.head( count );
+                    tileMean.head( count ) += delta.head( count ) * ( 1.0 / ( frame + 1 ) );
+                    tileM2.head( count ) += delta.head( count ) * ( x.head( count ) - tileMean.head( count ) );
+                    tileMinimum.head( count ) = tileMinimum.head( count ).min( x.head( count ) );
+                    tileMaximum.head( count ) = tileMaximum.head( count ).max( x.head( count ) );
+
+                    if ( keepValues ) convertPixels( source, values.data() + ( frame * tileDim ), count );
+                }
+
+                for ( std::size_t pixel = 0; pixel < count; ++pixel ) {
+                    mean[ first + pixel ] = tileMean( pixel );
+                    variance[ first + pixel ] = tileM2( pixel ) / frames;
+                    minimum[ first + pixel ] = tileMinimum( pixel );
+                    maximum[ first + pixel ] = tileMaximum( pixel );
+                }
+
+                if ( not keepValues ) continue;
+
+                // Gather the values of a few pixels at a time, so the gather stays in cache, and select their middle values
+                for ( std::size_t block = 0; block < count; block += medianBlock ) {
+                    const std::size_t blockDim = std::min( medianBlock, count - block );
+                    for ( std::size_t frame = 0; frame < frames; ++frame ) {
+                        for ( std::size_t pixel = 0; pixel < blockDim; ++pixel ) pixelValues[ ( pixel * frames ) + frame ] = values[ ( frame * tileDim ) + block + pixel ];
+                    }
+
+                    for ( std::size_t pixel = 0; pixel < blockDim; ++pixel ) {
+                        const auto begin = pixelValues.begin() + ( pixel * frames );
+                        const auto middle = begin + ( frames / 2 );
+                        std::nth_element( begin, middle, begin + frames );
+                        median[ first + block + pixel ] = ( frames % 2 ) ? *middle : ( *middle + *std::max_element( begin, middle ) ) / 2.0;
+                    }
+                }
+            }
+        } catch ( ... ) {
+            errors.at( worker ) = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for ( std::size_t worker = 1; worker < threads; ++worker ) pool.emplace_back( processTiles, worker );
+    processTiles( 0 );
+    for ( auto& thread : pool ) thread.join();
+    for ( auto& error : errors ) if ( error ) std::rethrow_exception( error );
+
+    typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorArrayXXd;
+    auto toFrame = [rows, columns]( const std::vector<double>& values ) {
+        return Eigen::Map<const RowMajorArrayXXd>( values.data(), rows, columns );
+    };
+
+    if ( quantities & Statistics::MEAN ) statistics.mean = toFrame( mean ).template cast<float>();
+    if ( quantities & Statistics::VARIANCE ) statistics.variance = toFrame( variance ).template cast<float>();
+    if ( quantities & Statistics::DEVIATION ) statistics.deviation = toFrame( variance ).sqrt().template cast<float>();
+    if ( quantities & Statistics::MINIMUM ) statistics.minimum = toFrame( minimum ).template cast<float>();
+    if ( quantities & Statistics::MAXIMUM ) statistics.maximum = toFrame( maximum ).template cast<float>();
+    if ( quantities & Statistics::MEDIAN ) statistics.median = toFrame( median ).template cast<float>();
+
+    return statistics;
+}
+
+// The reductions are only instantiated for the datatypes of SPE files
+template Eigen::ArrayXXf averageFrames<float>( const std::size_t, const std::size_t, const std::vector<std::pair<std::size_t, std::size_t>>&, unsigned, const PixelReader<float>& );
+template Eigen::ArrayXXf averageFrames<std::int32_t>( const std::size_t, const std::size_t, const std::vector<std::pair<std::size_t, std::size_t>>&, unsigned, const PixelReader<std::int32_t>& );
+template Eigen::ArrayXXf averageFrames<std::int16_t>( const std::size_t, const std::size_t, const std::vector<std::pair<std::size_t, std::size_t>>&, unsigned, const PixelReader<std::int16_t>& );
+template Eigen::ArrayXXf averageFrames<std::uint16_t>( const std::size_t, const std::size_t, const std::vector<std::pair<std::size_t, std::size_t>>&, unsigned, const PixelReader<std::uint16_t>& );
+
+template Statistics frameStatistics<float>( const std::size_t, const std::size_t, const std::size_t, const unsigned, const std::size_t, unsigned, const PixelReader<float>& );
+template Statistics frameStatistics<std::int32_t>( const std::size_t, const std::size_t, const std::size_t, const unsigned, const std::size_t, unsigned, const PixelReader<std::int32_t>& );
+template Statistics frameStatistics<std::int16_t>( const std::size_t, const std::size_t, const std::size_t, const unsigned, const std::size_t, unsigned, const PixelReader<std::int16_t>& );
+template Statistics frameStatistics<std::uint16_t>( const std::size_t, const std::size_t, const std::size_t, const unsigned, const std::size_t, unsigned, const PixelReader<std::uint16_t>& );
+}
@@ -15,6 +15,7 @@
 // You should have received a copy of the GNU General Public License
 // along with libSPE. If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <iomanip>
 
 #include "roiData.h"
@@ -31,7 +32,68 @@ ROIData::ROIData( const std::size_t OFFSET ) : Data( OFFSET, 12 )
 void ROIData::read( std::ifstream& file )
 {
     Data::read( file );
+    decode();
+}
+
+/*!
+ * \param header The header data to extract the ROI info block from
+ * \return void
+ */
+void ROIData::read( const Data& header )
+{
+    Data::read( header );
+    decode();
+}
+
+/*!
+ * \param file The file stream to write data to
+ * \return void
+ */
+void ROIData::write( std::ostream& file )
+{
+    encode();
+    Data::write( file );
+}
+
+/*!
+ * \param header The header data to write the ROI info block into
+ * \return void
+ */
+void ROIData::write( Data& header )
+{
+    encode();
+    Data::write( header );
+}
 
+/*!
+ * \param other The ROI info block to compare to
+ * \return Whether all fields of both blocks are equal
+ */
+bool ROIData::operator==( const ROIData& other ) const
+{
+    return startx == other.startx and endx == other.endx and groupx == other.groupx and starty == other.starty and endy == other.endy and groupy == other.groupy;
+}
+
+/*!
+ * \return The number of rows of pixels in the ROI
+ */
+std::size_t ROIData::rows() const
+{
+    if ( endy < starty ) return 0;
+    return ( endy - starty + 1 ) / std::max<std::uint16_t>( groupy, 1 );
+}
+
+/*!
+ * \return The number of columns of pixels in the ROI
+ */
+std::size_t ROIData::columns() const
+{
+    if ( endx < startx ) return 0;
+    return ( endx - startx + 1 ) / std::max<std::uint16_t>( groupx, 1 );
+}
+
+void ROIData::decode()
+{
     retrieve( startx, 0 );
     retrieve( endx, 2 );
     retrieve( groupx, 4 );
@@ -40,6 +102,16 @@ void ROIData::read( std::ifstream& file )
     retrieve( groupy, 10 );
 }
 
+void ROIData::encode()
+{
+    store( startx, 0 );
+    store( endx, 2 );
+    store( groupx, 4 );
+    store( starty, 6 );
+    store( endy, 8 );
+    store( groupy, 10 );
+}
+
 void ROIData::reset()
 {
     Data::reset();
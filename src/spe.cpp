@@ -15,42 +15,66 @@
 // You should have received a copy of the GNU General Public License
 // along with libSPE. If not, see <http://www.gnu.org/licenses/>.
 
-#include <vector>
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <stdexcept>
 
 #include "spe.h"
+#include "reduction.h"
 #include "data.h"
 #include "metadata.h"
 
 namespace SPE {
 /*!
  * \param filePath The path to the SPE file
+ * \param lazy Whether to decode metadata fields only when they are accessed
  */
-File::File( const std::string& filePath )
+File::File( const std::string& filePath, const bool lazy )
 {
     // Verify that the given file path exists
     struct stat buffer;
     if ( stat( filePath.c_str(), &buffer ) ) throw std::runtime_error( "File " + filePath + " does not exist." );
 
-    read( filePath );
+    read( filePath, lazy );
 }
 
 File::~File()
 {
-    if(  file.is_open() ) file.close();
+    unmap();
+    if ( fileDescriptor >= 0 ) close( fileDescriptor );
 }
 
 /*!
  * \param filePath The path to the SPE file
+ * \param lazy Whether to decode metadata fields only when they are accessed
  */
-void File::read( const std::string& filePath )
+void File::read( const std::string& filePath, const bool lazy )
 {
-    if ( file.is_open() ) file.close();
+    unmap();
+    if ( fileDescriptor >= 0 ) close( fileDescriptor );
+
+    cache.clear();
+
+    this->filePath = filePath;
+    fileDescriptor = open( filePath.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + filePath + " could not be opened." );
+
+    if ( lazy ) {
+        metadata.load( fileDescriptor );
 
-    file.open( filePath.c_str(), std::ios::in | std::ios::binary );
-    metadata.read( file );
+        // Decode the fields needed to read frames now, so reading frames never changes the metadata
+        metadata.get<Field::NumROI>();
+        metadata.get<Field::ROIinfoblk>();
+    } else {
+        metadata.read( fileDescriptor );
+    }
 }
 
 /*!
@@ -75,11 +99,94 @@ float File::getPixel( const unsigned short row, const unsigned short col, const
     }
 }
 
+/*!
+ * \param row The index of the row of the image, starts at 0
+ * \param col The index of the column of the image, starts at 0
+ * \return An array of the intensities of the pixel, one per frame
+ */
+Eigen::ArrayXf File::getPixelTrace( const unsigned short row, const unsigned short col )
+{
+    return getPixelTraces( { std::make_pair( row, col ) } ).col( 0 );
+}
+
+/*!
+ * \param pixels The pixels of the image, as pairs of the index of the row and the index of the column, starting at 0
+ * \return An array of the intensities of the pixels, with one row per frame and one column per pixel
+ */
+Eigen::ArrayXXf File::getPixelTraces( const std::vector<std::pair<unsigned short, unsigned short>>& pixels )
+{
+    std::vector<std::size_t> indices;
+    for ( auto& pixel : pixels ) {
+        if ( pixel.first >= metadata.ydim() or pixel.second >= metadata.xdim() ) throw std::out_of_range( "Pixel does not exist in the frame." );
+        indices.push_back( ( metadata.xdim() * pixel.first ) + pixel.second );
+    }
+
+    Eigen::ArrayXXf traces( metadata.NumFrames(), pixels.size() );
+
+    switch ( metadata.datatype() ) {
+        case 0:
+            traces = getPixelTraceArrays<float>( indices );
+            break;
+        case 1:
+            traces = getPixelTraceArrays<std::int32_t>( indices );
+            break;
+        case 2:
+            traces = getPixelTraceArrays<std::int16_t>( indices );
+            break;
+        case 3:
+            traces = getPixelTraceArrays<std::uint16_t>( indices );
+            break;
+    }
+
+    return traces;
+}
+
 /*!
  * \param frame The index of the frame of the image, starts at 0
  * \return An array of pixel intensities forming one frame of the image
  */
 Eigen::ArrayXXf File::getFrame( const long frame )
+{
+    if ( cache.enabled() ) return *getSharedFrame( frame );
+
+    return decodeFrame( frame );
+}
+
+/*!
+ * \param frame The index of the frame of the image, starts at 0
+ * \return A shared array of pixel intensities forming one frame of the image
+ */
+std::shared_ptr<const Eigen::ArrayXXf> File::getSharedFrame( const long frame )
+{
+    auto frameArray = cache.find( frame );
+    if ( frameArray ) return frameArray;
+
+    frameArray = std::make_shared<const Eigen::ArrayXXf>( decodeFrame( frame ) );
+    cache.insert( frame, frameArray );
+
+    return frameArray;
+}
+
+//! \param budget The most memory, in bytes, the cached frames may take up
+void File::setCacheBudget( const std::size_t budget )
+{
+    if ( budget == 0 ) cache.clear();
+    cache.setBudget( budget );
+}
+
+/*!
+ * \return The frame cache of the SPE file
+ */
+const FrameCache& File::frameCache() const
+{
+    return cache;
+}
+
+/*!
+ * \param frame The index of the frame of the image, starts at 0
+ * \return An array of pixel intensities forming one frame of the image
+ */
+Eigen::ArrayXXf File::decodeFrame( const long frame )
 {
     switch ( metadata.datatype() ) {
         case 0:
@@ -96,21 +203,332 @@ Eigen::ArrayXXf File::getFrame( const long frame )
 }
 
 /*!
- * \return An array of pixel intensities forming the average of all frames in the SPE file
+ * \param frame The index of the frame of the image, starts at 0
+ * \return A row-major array of pixel intensities forming one frame of the image
  */
-Eigen::ArrayXXf File::getAverageFrame()
+RowMajorArrayXXf File::getRowMajorFrame( const long frame )
 {
-    Eigen::ArrayXXf averageFrame( metadata.ydim(), metadata.xdim() );
+    switch ( metadata.datatype() ) {
+        case 0:
+            return getRowMajorFrameArray<float>( frame );
+        case 1:
+            return getRowMajorFrameArray<std::int32_t>( frame );
+        case 2:
+            return getRowMajorFrameArray<std::int16_t>( frame );
+        case 3:
+            return getRowMajorFrameArray<std::uint16_t>( frame );
+        default:
+            return RowMajorArrayXXf( metadata.ydim(), metadata.xdim() );
+    }
+}
 
-    for ( auto frame = 0; frame < metadata.NumFrames(); ++frame ) {
-        averageFrame += getFrame( frame );
+/*!
+ * \param frame The index of the frame of the image, starts at 0
+ * \param roi The index of the ROI, starts at 0
+ * \return An array of pixel intensities forming one ROI of one frame of the image
+ */
+Eigen::ArrayXXf File::getROI( const long frame, const std::size_t roi )
+{
+    return getROIs( frame, { roi } ).front();
+}
+
+/*!
+ * \param frame The index of the frame of the image, starts at 0
+ * \param rois The indices of the ROIs, starting at 0
+ * \return Arrays of pixel intensities forming the ROIs of one frame of the image, in the order they were requested
+ */
+std::vector<Eigen::ArrayXXf> File::getROIs( const long frame, const std::vector<std::size_t>& rois )
+{
+    if ( frame < 0 or frame >= metadata.NumFrames() ) throw std::out_of_range( "Frame does not exist in the file." );
+    for ( auto roi : rois ) {
+        if ( roi >= this->rois() ) throw std::out_of_range( "ROI does not exist in the frame." );
+    }
+
+    std::vector<Eigen::ArrayXXf> roiArrays;
+
+    switch ( metadata.datatype() ) {
+        case 0:
+            roiArrays = getROIArrays<float>( frame, rois );
+            break;
+        case 1:
+            roiArrays = getROIArrays<std::int32_t>( frame, rois );
+            break;
+        case 2:
+            roiArrays = getROIArrays<std::int16_t>( frame, rois );
+            break;
+        case 3:
+            roiArrays = getROIArrays<std::uint16_t>( frame, rois );
+            break;
+        default:
+            // Like the frames of an unknown datatype, each ROI has its size but no pixel intensities
+            for ( auto roi : rois ) {
+                std::size_t offset, rows, cols;
+                roiLayout( roi, offset, rows, cols );
+                roiArrays.emplace_back( rows, cols );
+            }
+            break;
+    }
+
+    return roiArrays;
+}
+
+/*!
+ * \param frame The index of the frame of the image, starts at 0
+ * \param groupx The number of columns of pixels in each bin
+ * \param groupy The number of rows of pixels in each bin
+ * \param mean Whether each bin holds the mean of its pixels instead of the sum
+ * \return An array of binned pixel intensities forming one frame of the image
+ */
+Eigen::ArrayXXf File::getBinnedFrame( const long frame, const unsigned short groupx, const unsigned short groupy, const bool mean )
+{
+    if ( frame < 0 or frame >= metadata.NumFrames() ) throw std::out_of_range( "Frame does not exist in the file." );
+    if ( groupx == 0 or groupy == 0 or groupx > metadata.xdim() or groupy > metadata.ydim() ) throw std::out_of_range( "Bins do not fit in the frame." );
+
+    Eigen::ArrayXXf binnedFrame( metadata.ydim() / groupy, metadata.xdim() / groupx );
+
+    switch ( metadata.datatype() ) {
+        case 0:
+            binnedFrame = getBinnedFrameArray<float>( frame, groupx, groupy, mean );
+            break;
+        case 1:
+            binnedFrame = getBinnedFrameArray<std::int32_t>( frame, groupx, groupy, mean );
+            break;
+        case 2:
+            binnedFrame = getBinnedFrameArray<std::int16_t>( frame, groupx, groupy, mean );
+            break;
+        case 3:
+            binnedFrame = getBinnedFrameArray<std::uint16_t>( frame, groupx, groupy, mean );
+            break;
+    }
+
+    return binnedFrame;
+}
+
+/*!
+ * \param frame The index of the frame of the image, starts at 0
+ * \param row The index of the first row of the region, starts at 0
+ * \param col The index of the first column of the region, starts at 0
+ * \param rows The number of rows in the region
+ * \param cols The number of columns in the region
+ * \return An array of pixel intensities forming the region of one frame of the image
+ */
+Eigen::ArrayXXf File::getFrameRegion( const long frame, const unsigned short row, const unsigned short col, const unsigned short rows, const unsigned short cols )
+{
+    return getFrameRegions( frame, 1, row, col, rows, cols ).frame( 0 );
+}
+
+/*!
+ * \param first The index of the first frame to fetch, starts at 0
+ * \param count The number of frames to fetch
+ * \param row The index of the first row of the region, starts at 0
+ * \param col The index of the first column of the region, starts at 0
+ * \param rows The number of rows in the region
+ * \param cols The number of columns in the region
+ * \return A stack of the region of each fetched frame, in the order they appear in the file
+ */
+FrameStack File::getFrameRegions( const long first, const long count, const unsigned short row, const unsigned short col, const unsigned short rows, const unsigned short cols )
+{
+    if ( first < 0 or count < 0 ) throw std::out_of_range( "Invalid range of frames." );
+    if ( count > 0 and first + count > metadata.NumFrames() ) throw std::out_of_range( "Frame does not exist in the file." );
+    if ( row + rows > metadata.ydim() or col + cols > metadata.xdim() ) throw std::out_of_range( "Region does not fit in the frame." );
+
+    FrameStack stack( count, rows, cols );
+
+    switch ( metadata.datatype() ) {
+        case 0:
+            readFrameRegions<float>( first, row, col, stack );
+            break;
+        case 1:
+            readFrameRegions<std::int32_t>( first, row, col, stack );
+            break;
+        case 2:
+            readFrameRegions<std::int16_t>( first, row, col, stack );
+            break;
+        case 3:
+            readFrameRegions<std::uint16_t>( first, row, col, stack );
+            break;
     }
 
-    averageFrame /= metadata.NumFrames();
+    return stack;
+}
+
+/*!
+ * \param threads The number of threads to use, or 0 for one thread per core
+ * \return An array of pixel intensities forming the average of all frames in the SPE file
+ */
+Eigen::ArrayXXf File::getAverageFrame( const unsigned threads )
+{
+    Eigen::ArrayXXf averageFrame = Eigen::ArrayXXf::Zero( metadata.ydim(), metadata.xdim() );
+
+    switch ( metadata.datatype() ) {
+        case 0:
+            averageFrame = getAverageFrameArray<float>( threads );
+            break;
+        case 1:
+            averageFrame = getAverageFrameArray<std::int32_t>( threads );
+            break;
+        case 2:
+            averageFrame = getAverageFrameArray<std::int16_t>( threads );
+            break;
+        case 3:
+            averageFrame = getAverageFrameArray<std::uint16_t>( threads );
+            break;
+    }
 
     return averageFrame;
 }
 
+/*!
+ * \param quantities The statistics to calculate, as SPE::Statistics::Quantity values combined with a bitwise or
+ * \param memoryBudget The most working memory to use, in bytes
+ * \param threads The number of threads to use, or 0 for one thread per core
+ * \return The requested per-pixel statistics over all frames in the SPE file
+ */
+Statistics File::getStatistics( const unsigned quantities, const std::size_t memoryBudget, const unsigned threads )
+{
+    Statistics statistics;
+
+    switch ( metadata.datatype() ) {
+        case 0:
+            statistics = getStatisticsArrays<float>( quantities, memoryBudget, threads );
+            break;
+        case 1:
+            statistics = getStatisticsArrays<std::int32_t>( quantities, memoryBudget, threads );
+            break;
+        case 2:
+            statistics = getStatisticsArrays<std::int16_t>( quantities, memoryBudget, threads );
+            break;
+        case 3:
+            statistics = getStatisticsArrays<std::uint16_t>( quantities, memoryBudget, threads );
+            break;
+    }
+
+    return statistics;
+}
+
+/*!
+ * \param first The index of the first frame to fetch, starts at 0
+ * \param count The number of frames to fetch
+ * \param stride The number of frames to step from one fetched frame to the next
+ * \return A stack of the fetched frames, in the order they appear in the file
+ */
+FrameStack File::getFrames( const long first, const long count, const long stride )
+{
+    if ( first < 0 or count < 0 or stride < 1 ) throw std::out_of_range( "Invalid range of frames." );
+    if ( count > 0 and first + ( ( count - 1 ) * stride ) >= metadata.NumFrames() ) throw std::out_of_range( "Frame does not exist in the file." );
+
+    FrameStack stack( count, metadata.ydim(), metadata.xdim() );
+
+    switch ( metadata.datatype() ) {
+        case 0:
+            readFrames<float>( first, stride, stack );
+            break;
+        case 1:
+            readFrames<std::int32_t>( first, stride, stack );
+            break;
+        case 2:
+            readFrames<std::int16_t>( first, stride, stack );
+            break;
+        case 3:
+            readFrames<std::uint16_t>( first, stride, stack );
+            break;
+        default:
+            break;
+    }
+
+    return stack;
+}
+
+/*!
+ * \param buffer The buffer to read into
+ * \param size The number of bytes to read
+ * \param offset The position in the file to read from
+ */
+void File::readBytes( char* buffer, const std::size_t size, const std::size_t offset ) const
+{
+    std::size_t done = 0;
+    while ( done < size ) {
+        const auto count = pread( fileDescriptor, buffer + done, size - done, offset + done );
+        if ( count <= 0 ) throw std::runtime_error( "Frame could not be read from the file." );
+        done += count;
+    }
+}
+
+void File::map()
+{
+    if ( isMapped() ) return;
+
+    struct stat buffer;
+    if ( fstat( fileDescriptor, &buffer ) or buffer.st_size == 0 ) throw std::runtime_error( "File " + filePath + " could not be mapped." );
+
+    auto address = mmap( nullptr, buffer.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0 );
+    if ( address == MAP_FAILED ) throw std::runtime_error( "File " + filePath + " could not be mapped." );
+
+    mapping = static_cast<const char*>( address );
+    mappingSize = buffer.st_size;
+}
+
+void File::unmap()
+{
+    if ( not isMapped() ) return;
+
+    munmap( const_cast<char*>( mapping ), mappingSize );
+    mapping = nullptr;
+    mappingSize = 0;
+}
+
+/*!
+ * \return The number of ROIs in each frame of the image
+ */
+std::size_t File::rois()
+{
+    const std::size_t count = metadata.get<Field::NumROI>();
+    if ( count < 2 or count > ROIMAX ) return 1;
+
+    // The ROIs must account for every pixel of the frame
+    std::size_t pixels = 0;
+    for ( std::size_t roi = 0; roi < count; ++roi ) {
+        const auto& roiData = metadata.get<Field::ROIinfoblk>().at( roi );
+        if ( roiData.rows() == 0 or roiData.columns() == 0 ) return 1;
+        pixels += roiData.rows() * roiData.columns();
+    }
+
+    return ( pixels == metadata.xdim() * metadata.ydim() ) ? count : 1;
+}
+
+/*!
+ * \param roi The index of the ROI, starts at 0
+ * \param offset The number of pixels in a frame before the ROI
+ * \param rows The number of rows of pixels in the ROI
+ * \param cols The number of columns of pixels in the ROI
+ */
+void File::roiLayout( const std::size_t roi, std::size_t& offset, std::size_t& rows, std::size_t& cols )
+{
+    const auto count = this->rois();
+    if ( roi >= count ) throw std::out_of_range( "ROI does not exist in the frame." );
+
+    if ( count == 1 ) {
+        offset = 0;
+        rows = metadata.ydim();
+        cols = metadata.xdim();
+        return;
+    }
+
+    const auto& roiInfo = metadata.get<Field::ROIinfoblk>();
+    offset = 0;
+    for ( std::size_t previous = 0; previous < roi; ++previous ) offset += roiInfo.at( previous ).rows() * roiInfo.at( previous ).columns();
+    rows = roiInfo.at( roi ).rows();
+    cols = roiInfo.at( roi ).columns();
+}
+
+/*!
+ * \return Whether the SPE file is memory-mapped
+ */
+bool File::isMapped() const
+{
+    return mapping != nullptr;
+}
+
 /*!
  * \return The number of rows in one frame of the image
  */
@@ -134,5 +552,277 @@ std::size_t File::frames() const
 {
     return metadata.NumFrames();
 }
+
+template<class T> Eigen::ArrayXXf File::getAverageFrameArray( unsigned threads ) const
+{
+    // Each thread sums this many consecutive frames before its sum is added to the total
+    const std::size_t blockSize = 32;
+
+    std::vector<std::pair<std::size_t, std::size_t>> blocks;
+    for ( std::size_t frame = 0; frame < frames(); frame += blockSize ) blocks.push_back( std::make_pair( frame, std::min( blockSize, frames() - frame ) ) );
+
+    return averageFrames<T>( rows(), columns(), blocks, threads, [this]( const std::size_t frame, const std::size_t first, const std::size_t count, T* buffer ) {
+        return readPixels( frame, first, count, buffer );
+    } );
 }
 
+template<class T> Statistics File::getStatisticsArrays( const unsigned quantities, const std::size_t memoryBudget, unsigned threads ) const
+{
+    return frameStatistics<T>( rows(), columns(), frames(), quantities, memoryBudget, threads, [this]( const std::size_t frame, const std::size_t first, const std::size_t count, T* buffer ) {
+        return readPixels( frame, first, count, buffer );
+    } );
+}
+
+template<class T> Eigen::ArrayXXf File::getPixelTraceArrays( const std::vector<std::size_t>& indices ) const
+{
+    // Read a chunk of about this many bytes at a time and read through gaps between pixels up to this size, about the cost of one more read
+    const std::size_t chunkSize = 16 << 20;
+    const std::size_t gapSize = 4 << 10;
+
+    const std::size_t frameDim = metadata.xdim() * metadata.ydim();
+    const std::size_t frameSize = sizeof( T ) * frameDim;
+    const std::size_t frames = metadata.NumFrames();
+
+    Eigen::ArrayXXf traces( frames, indices.size() );
+    if ( indices.empty() or frames == 0 ) return traces;
+
+    if ( isMapped() ) {
+        for ( std::size_t frame = 0; frame < frames; ++frame ) {
+            const T* source = mapFrame<T>( frame ).data();
+            for ( std::size_t pixel = 0; pixel < indices.size(); ++pixel ) traces( frame, pixel ) = source[ indices[ pixel ] ];
+        }
+        return traces;
+    }
+
+    // Group the pixels into runs that are each read in one go
+    std::vector<std::size_t> sorted( indices );
+    std::sort( sorted.begin(), sorted.end() );
+    std::vector<std::pair<std::size_t, std::size_t>> runs( 1, std::make_pair( sorted.front(), sorted.front() + 1 ) );
+    for ( auto index : sorted ) {
+        if ( index < runs.back().second or sizeof( T ) * ( index - runs.back().second ) <= gapSize ) {
+            runs.back().second = std::max( runs.back().second, index + 1 );
+        } else {
+            runs.push_back( std::make_pair( index, index + 1 ) );
+        }
+    }
+
+    std::size_t runDim = 0;
+    for ( auto& run : runs ) runDim += run.second - run.first;
+
+    const std::size_t first = runs.front().first;
+    const std::size_t span = runs.back().second - first;
+
+    // Frames are read whole, many at a time, when that costs less than reading each run of each frame on its own
+    if ( frameSize <= ( sizeof( T ) * runDim ) + ( gapSize * runs.size() ) ) {
+        const std::size_t framesPerChunk = std::min( std::max<std::size_t>( chunkSize / frameSize, 1 ), frames );
+        std::vector<T> pixels( ( ( framesPerChunk - 1 ) * frameDim ) + span );
+
+        for ( std::size_t frame = 0; frame < frames; frame += framesPerChunk ) {
+            const std::size_t chunkFrames = std::min( framesPerChunk, frames - frame );
+            const std::size_t length = ( ( chunkFrames - 1 ) * frameDim ) + span;
+            readBytes( reinterpret_cast<char*>( pixels.data() ), sizeof( T ) * length, OFFSET_DATA + ( frameSize * frame ) + ( sizeof( T ) * first ) );
+
+            for ( std::size_t chunkFrame = 0; chunkFrame < chunkFrames; ++chunkFrame ) {
+                for ( std::size_t pixel = 0; pixel < indices.size(); ++pixel ) traces( frame + chunkFrame, pixel ) = pixels[ ( chunkFrame * frameDim ) + indices[ pixel ] - first ];
+            }
+        }
+
+        return traces;
+    }
+
+    // Otherwise read each run of each frame on its own
+    std::vector<T> pixels( frameDim );
+    for ( std::size_t frame = 0; frame < frames; ++frame ) {
+        for ( auto& run : runs ) {
+            readBytes( reinterpret_cast<char*>( pixels.data() + run.first ), sizeof( T ) * ( run.second - run.first ), OFFSET_DATA + ( frameSize * frame ) + ( sizeof( T ) * run.first ) );
+        }
+        for ( std::size_t pixel = 0; pixel < indices.size(); ++pixel ) traces( frame, pixel ) = pixels[ indices[ pixel ] ];
+    }
+
+    return traces;
+}
+
+template<class T> Eigen::ArrayXXf File::getBinnedFrameArray( const long frame, const std::size_t groupx, const std::size_t groupy, const bool mean ) const
+{
+    // Read about this many bytes of rows at a time
+    const std::size_t chunkSize = 1 << 20;
+
+    const std::size_t xdim = metadata.xdim();
+    const std::size_t binnedRows = metadata.ydim() / groupy;
+    const std::size_t binnedCols = xdim / groupx;
+    const std::size_t rows = binnedRows * groupy;
+    const std::size_t cols = binnedCols * groupx;
+    const std::size_t rowSize = sizeof( T ) * xdim;
+    const std::size_t chunkRows = std::min( std::max<std::size_t>( chunkSize / rowSize, 1 ), std::max<std::size_t>( rows, 1 ) );
+
+    Eigen::ArrayXXf binnedFrame( binnedRows, binnedCols );
+    if ( binnedRows == 0 or binnedCols == 0 ) return binnedFrame;
+
+    std::vector<T> pixels( isMapped() ? 0 : chunkRows * xdim );
+    Eigen::ArrayXf values( cols );
+    Eigen::ArrayXd rowSum = Eigen::ArrayXd::Zero( cols );
+    const double scale = mean ? 1.0 / ( groupx * groupy ) : 1.0;
+
+    const T* source = isMapped() ? mapFrame<T>( frame ).data() : nullptr;
+    for ( std::size_t chunk = 0; chunk < rows; chunk += chunkRows ) {
+        const std::size_t count = std::min( chunkRows, rows - chunk );
+        if ( not isMapped() ) {
+            readBytes( reinterpret_cast<char*>( pixels.data() ), rowSize * count, OFFSET_DATA + ( rowSize * ( ( metadata.ydim() * frame ) + chunk ) ) );
+        }
+
+        for ( std::size_t chunkRow = 0; chunkRow < count; ++chunkRow ) {
+            const std::size_t row = chunk + chunkRow;
+            const T* rowPixels = isMapped() ? source + ( row * xdim ) : pixels.data() + ( chunkRow * xdim );
+
+            // Add up the rows of a bin first, then the columns of each bin once all its rows are in
+            convertPixels( rowPixels, values.data(), cols );
+            rowSum += values.cast<double>();
+
+            if ( ( row + 1 ) % groupy == 0 ) {
+                const Eigen::Map<const Eigen::ArrayXXd> bins( rowSum.data(), groupx, binnedCols );
+                binnedFrame.row( row / groupy ) = ( bins.colwise().sum() * scale ).cast<float>();
+                rowSum.setZero();
+            }
+        }
+    }
+
+    return binnedFrame;
+}
+
+template<class T> void File::readFrameRegions( const long first, const std::size_t row, const std::size_t col, FrameStack& stack ) const
+{
+    // Read about this many bytes at a time and read through gaps between rows and frames up to this size
+    const std::size_t chunkSize = 16 << 20;
+    const std::size_t gapSize = 4 << 10;
+
+    const std::size_t xdim = metadata.xdim();
+    const std::size_t frameDim = xdim * metadata.ydim();
+    const std::size_t frameSize = sizeof( T ) * frameDim;
+    const std::size_t rows = stack.rows();
+    const std::size_t cols = stack.columns();
+    const std::size_t count = stack.frames();
+    if ( rows == 0 or cols == 0 or count == 0 ) return;
+
+    // The region of each frame starts this far into the frame and the rows covering it span this many pixels
+    const std::size_t start = ( row * xdim ) + col;
+    const std::size_t block = ( ( rows - 1 ) * xdim ) + cols;
+
+    auto convertRegion = [&]( const T* source, const std::size_t frame ) {
+        float* values = stack.frame( frame ).data();
+        if ( cols == xdim ) {
+            convertPixels( source, values, rows * cols );
+        } else {
+            for ( std::size_t regionRow = 0; regionRow < rows; ++regionRow ) convertPixels( source + ( regionRow * xdim ), values + ( regionRow * cols ), cols );
+        }
+    };
+
+    if ( isMapped() ) {
+        for ( std::size_t frame = 0; frame < count; ++frame ) convertRegion( mapFrame<T>( first + frame ).data() + start, frame );
+        return;
+    }
+
+    // Rows close to each other are read as one block, which is then converted in place
+    if ( sizeof( T ) * ( xdim - cols ) <= gapSize ) {
+        const bool coalesce = sizeof( T ) * ( frameDim - block ) <= gapSize;
+        const std::size_t framesPerChunk = coalesce ? std::min( std::max<std::size_t>( chunkSize / frameSize, 1 ), count ) : 1;
+        std::vector<T> pixels( ( ( framesPerChunk - 1 ) * frameDim ) + block );
+
+        for ( std::size_t frame = 0; frame < count; frame += framesPerChunk ) {
+            const std::size_t chunkFrames = std::min( framesPerChunk, count - frame );
+            const std::size_t length = ( ( chunkFrames - 1 ) * frameDim ) + block;
+            readBytes( reinterpret_cast<char*>( pixels.data() ), sizeof( T ) * length, OFFSET_DATA + ( frameSize * ( first + frame ) ) + ( sizeof( T ) * start ) );
+
+            for ( std::size_t chunkFrame = 0; chunkFrame < chunkFrames; ++chunkFrame ) convertRegion( pixels.data() + ( chunkFrame * frameDim ), frame + chunkFrame );
+        }
+
+        return;
+    }
+
+    // Otherwise each row of the region is read on its own
+    std::vector<T> pixels( rows * cols );
+    for ( std::size_t frame = 0; frame < count; ++frame ) {
+        for ( std::size_t regionRow = 0; regionRow < rows; ++regionRow ) {
+            readBytes( reinterpret_cast<char*>( pixels.data() + ( regionRow * cols ) ), sizeof( T ) * cols, OFFSET_DATA + ( frameSize * ( first + frame ) ) + ( sizeof( T ) * ( start + ( regionRow * xdim ) ) ) );
+        }
+        convertPixels( pixels.data(), stack.frame( frame ).data(), rows * cols );
+    }
+}
+
+template<class T> void File::readFrames( const long first, const long stride, FrameStack& stack ) const
+{
+    // Read about this many bytes at a time and read through gaps between strided frames up to this size
+    const std::size_t chunkSize = 16 << 20;
+    const std::size_t gapSize = 1 << 20;
+
+    const std::size_t frameDim = stack.rows() * stack.columns();
+    const std::size_t frameSize = sizeof( T ) * frameDim;
+    const std::size_t count = stack.frames();
+    if ( frameDim == 0 or count == 0 ) return;
+
+    if ( isMapped() ) {
+        if ( stride == 1 ) {
+            // Viewing the last frame checks that all of them lie within the mapping
+            mapFrame<T>( first + count - 1 );
+            convertPixels( mapFrame<T>( first ).data(), stack.data(), stack.size() );
+        } else {
+            for ( std::size_t frame = 0; frame < count; ++frame ) {
+                convertPixels( mapFrame<T>( first + ( frame * stride ) ).data(), stack.frame( frame ).data(), frameDim );
+            }
+        }
+        return;
+    }
+
+    const bool coalesce = stride == 1 or ( stride - 1 ) * frameSize <= gapSize;
+    const std::size_t span = coalesce ? stride * frameSize : frameSize;
+    const std::size_t framesPerChunk = coalesce ? std::min( std::max<std::size_t>( 1, chunkSize / span ), count ) : 1;
+
+    std::vector<T> pixels( ( ( ( framesPerChunk - 1 ) * ( coalesce ? stride : 1 ) ) + 1 ) * frameDim );
+
+    for ( std::size_t frame = 0; frame < count; frame += framesPerChunk ) {
+        const std::size_t frames = std::min( framesPerChunk, count - frame );
+        const std::size_t offset = OFFSET_DATA + ( frameSize * ( first + ( frame * stride ) ) );
+        const std::size_t length = ( ( frames - 1 ) * span ) + frameSize;
+
+        readBytes( reinterpret_cast<char*>( pixels.data() ), length, offset );
+
+        if ( stride == 1 ) {
+            convertPixels( pixels.data(), stack.frame( frame ).data(), frames * frameDim );
+        } else {
+            for ( std::size_t chunkFrame = 0; chunkFrame < frames; ++chunkFrame ) {
+                convertPixels( pixels.data() + ( chunkFrame * stride * frameDim ), stack.frame( frame + chunkFrame ).data(), frameDim );
+            }
+        }
+    }
+}
+
+// The engines above are only instantiated for the datatypes of SPE files
+template Eigen::ArrayXXf File::getAverageFrameArray<float>( unsigned ) const;
+template Eigen::ArrayXXf File::getAverageFrameArray<std::int32_t>( unsigned ) const;
+template Eigen::ArrayXXf File::getAverageFrameArray<std::int16_t>( unsigned ) const;
+template Eigen::ArrayXXf File::getAverageFrameArray<std::uint16_t>( unsigned ) const;
+
+template Statistics File::getStatisticsArrays<float>( const unsigned, const std::size_t, unsigned ) const;
+template Statistics File::getStatisticsArrays<std::int32_t>( const unsigned, const std::size_t, unsigned ) const;
+template Statistics File::getStatisticsArrays<std::int16_t>( const unsigned, const std::size_t, unsigned ) const;
+template Statistics File::getStatisticsArrays<std::uint16_t>( const unsigned, const std::size_t, unsigned ) const;
+
+template Eigen::ArrayXXf File::getPixelTraceArrays<float>( const std::vector<std::size_t>& ) const;
+template Eigen::ArrayXXf File::getPixelTraceArrays<std::int32_t>( const std::vector<std::size_t>& ) const;
+template Eigen::ArrayXXf File::getPixelTraceArrays<std::int16_t>( const std::vector<std::size_t>& ) const;
+template Eigen::ArrayXXf File::getPixelTraceArrays<std::uint16_t>( const std::vector<std::size_t>& ) const;
+
+template Eigen::ArrayXXf File::getBinnedFrameArray<float>( const long, const std::size_t, const std::size_t, const bool ) const;
+template Eigen::ArrayXXf File::getBinnedFrameArray<std::int32_t>( const long, const std::size_t, const std::size_t, const bool ) const;
+template Eigen::ArrayXXf File::getBinnedFrameArray<std::int16_t>( const long, const std::size_t, const std::size_t, const bool ) const;
+template Eigen::ArrayXXf File::getBinnedFrameArray<std::uint16_t>( const long, const std::size_t, const std::size_t, const bool ) const;
+
+template void File::readFrameRegions<float>( const long, const std::size_t, const std::size_t, FrameStack& ) const;
+template void File::readFrameRegions<std::int32_t>( const long, const std::size_t, const std::size_t, FrameStack& ) const;
+template void File::readFrameRegions<std::int16_t>( const long, const std::size_t, const std::size_t, FrameStack& ) const;
+template void File::readFrameRegions<std::uint16_t>( const long, const std::size_t, const std::size_t, FrameStack& ) const;
+
+template void File::readFrames<float>( const long, const long, FrameStack& ) const;
+template void File::readFrames<std::int32_t>( const long, const long, FrameStack& ) const;
+template void File::readFrames<std::int16_t>( const long, const long, FrameStack& ) const;
+template void File::readFrames<std::uint16_t>( const long, const long, FrameStack& ) const;
+}
@@ -0,0 +1,200 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "textExporter.h"
+#include "spe.h"
+
+namespace SPE {
+// Write out the text in blocks of this many bytes
+const std::size_t BUFFER_SIZE = 1 << 20;
+
+// Room for the longest value written, sign, digits, point and exponent, and its delimiter
+const std::size_t VALUE_SIZE = 32;
+
+// Nine significant digits are enough to tell any two floats apart
+const int MAX_PRECISION = 9;
+
+// Read this many bytes of frames at a time when exporting from an SPE file
+const std::size_t CHUNK_SIZE = 16 << 20;
+
+namespace {
+/*!
+ * \param first The start of the room for the value
+ * \param last The end of the room for the value
+ * \param value The value to format
+ * \param precision The number of significant digits, or 0 for the shortest representation that reads back exactly
+ * \return The end of the formatted value
+ */
+char* formatValue( char* first, char* last, const float value, const int precision )
+{
+    // Older standard libraries only provide std::to_chars for integers
+#if defined( __cpp_lib_to_chars )
+    return ( precision > 0 ? std::to_chars( first, last, value, std::chars_format::general, precision ) : std::to_chars( first, last, value ) ).ptr;
+#else
+    // Without std::to_chars, find the fewest significant digits that read back exactly
+    int length = 0;
+    for ( int digits = precision > 0 ? precision : 6; digits <= MAX_PRECISION; ++digits ) {
+        length = std::snprintf( first, last - first, "%.*g", digits, value );
+        if ( precision > 0 or value != value or std::strtof( first, nullptr ) == value ) break;
+    }
+    return first + length;
+#endif
+}
+}
+
+/*!
+ * \param path The path to the file to write
+ * \param precision The number of significant digits of each value, or 0 for the shortest representation that reads back exactly
+ * \param delimiter The character between values in a row
+ */
+TextExporter::TextExporter( const std::string& path, const int precision, const char delimiter ) : path( path ), precision( std::min( std::max( precision, 0 ), MAX_PRECISION ) ), delimiter( delimiter ), buffer( BUFFER_SIZE )
+{
+    fileDescriptor = ::open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 );
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + path + " could not be opened." );
+}
+
+TextExporter::~TextExporter()
+{
+    try {
+        close();
+    } catch ( ... ) {
+    }
+}
+
+/*!
+ * \param frame The frame to append
+ */
+void TextExporter::write( const Eigen::Ref<const Eigen::ArrayXXf>& frame )
+{
+    writeRows( frame.data(), frame.rows(), frame.cols(), 1, frame.outerStride() );
+}
+
+/*!
+ * \param frames The stack of frames to append
+ */
+void TextExporter::write( const FrameStack& frames )
+{
+    for ( std::size_t frame = 0; frame < frames.frames(); ++frame ) {
+        writeRows( frames.data() + ( frame * frames.rows() * frames.columns() ), frames.rows(), frames.columns(), frames.columns(), 1 );
+    }
+}
+
+/*!
+ * \param file The SPE file to read the frames from
+ * \param first The index of the first frame to append, starts at 0
+ * \param count The number of frames to append
+ */
+void TextExporter::write( File& file, const long first, const long count )
+{
+    const long chunkFrames = std::max<long>( CHUNK_SIZE / std::max<std::size_t>( sizeof( float ) * file.rows() * file.columns(), 1 ), 1 );
+    for ( long chunk = 0; chunk < count; chunk += chunkFrames ) write( file.getFrames( first + chunk, std::min( chunkFrames, count - chunk ) ) );
+}
+
+void TextExporter::close()
+{
+    if ( fileDescriptor < 0 ) return;
+
+    bool failed = false;
+    try {
+        flush();
+    } catch ( ... ) {
+        failed = true;
+    }
+
+    if ( ::close( fileDescriptor ) != 0 ) failed = true;
+    fileDescriptor = -1;
+
+    if ( failed ) throw std::runtime_error( "File " + path + " could not be written." );
+}
+
+/*!
+ * \return The number of frames written so far
+ */
+std::size_t TextExporter::frames() const
+{
+    return m_frames;
+}
+
+/*!
+ * \param path The path to the file to write
+ * \param frame The frame to save
+ * \param precision The number of significant digits of each value, or 0 for the shortest representation that reads back exactly
+ * \param delimiter The character between values in a row
+ */
+void TextExporter::save( const std::string& path, const Eigen::Ref<const Eigen::ArrayXXf>& frame, const int precision, const char delimiter )
+{
+    TextExporter exporter( path, precision, delimiter );
+    exporter.write( frame );
+    exporter.close();
+}
+
+/*!
+ * \param values The first value of the frame
+ * \param rows The number of rows in the frame
+ * \param columns The number of columns in the frame
+ * \param rowStride The distance between two rows of the frame, in values
+ * \param columnStride The distance between two columns of the frame, in values
+ */
+void TextExporter::writeRows( const float* values, const std::size_t rows, const std::size_t columns, const std::size_t rowStride, const std::size_t columnStride )
+{
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + path + " is already closed." );
+
+    // Separate frames with an empty line
+    if ( m_frames > 0 ) {
+        if ( used + 1 > buffer.size() ) flush();
+        buffer[ used++ ] = '\n';
+    }
+
+    for ( std::size_t row = 0; row < rows; ++row ) {
+        const float* rowValues = values + ( row * rowStride );
+        for ( std::size_t column = 0; column < columns; ++column ) {
+            if ( used + VALUE_SIZE > buffer.size() ) flush();
+
+            char* end = formatValue( buffer.data() + used, buffer.data() + used + VALUE_SIZE - 1, rowValues[ column * columnStride ], precision );
+            *end++ = ( column + 1 < columns ) ? delimiter : '\n';
+            used = end - buffer.data();
+        }
+    }
+
+    ++m_frames;
+}
+
+void TextExporter::flush()
+{
+    const char* data = buffer.data();
+    std::size_t size = used;
+    used = 0;
+
+    while ( size > 0 ) {
+        const auto written = ::write( fileDescriptor, data, size );
+        if ( written < 0 and errno == EINTR ) continue;
+        if ( written <= 0 ) throw std::runtime_error( "File " + path + " could not be written." );
+
+        data += written;
+        size -= written;
+    }
+}
+}
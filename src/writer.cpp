@@ -0,0 +1,204 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "writer.h"
+#include "datatype.h"
+#include "fields.h"
+#include "spe.h"
+
+namespace SPE {
+// Write out the frames in blocks of at least this many bytes
+const std::size_t BUFFER_SIZE = 4 << 20;
+
+/*!
+ * \param path The path to the SPE file to write
+ * \param rows The number of rows in each frame
+ * \param columns The number of columns in each frame
+ * \param datatype The datatype to store the frames in
+ * \param metadata The metadata to fill the header in from
+ */
+Writer::Writer( const std::string& path, const std::size_t rows, const std::size_t columns, const std::int16_t datatype, const Metadata& metadata ) : path( path ), metadata( metadata )
+{
+    if ( pixelSize( datatype ) == 0 ) throw std::runtime_error( "Datatype " + std::to_string( datatype ) + " is not supported." );
+    if ( rows > std::numeric_limits<std::uint16_t>::max() or columns > std::numeric_limits<std::uint16_t>::max() ) throw std::runtime_error( "Frame is too large for an SPE file." );
+
+    frameSize = rows * columns * pixelSize( datatype );
+    buffer.resize( std::max( BUFFER_SIZE, frameSize ) );
+
+    // Decode the last value of lazily loaded metadata, so it is encoded along with the header
+    this->metadata.get<Field::lastvalue>();
+    this->metadata.lastvalue = LASTVALUE;
+    this->metadata.m_xdim = columns;
+    this->metadata.m_ydim = rows;
+    this->metadata.m_datatype = datatype;
+    this->metadata.m_NumFrames = 0;
+
+    // The ROIs of metadata for another frame size do not describe these frames, so one ROI covering the whole frame takes their place
+    if ( metadata.xdim() != columns or metadata.ydim() != rows ) {
+        this->metadata.get<Field::NumROI>();
+        this->metadata.get<Field::ROIinfoblk>();
+        this->metadata.NumROI = ( rows > 0 and columns > 0 ) ? 1 : 0;
+        for ( auto& roi : this->metadata.ROIinfoblk ) roi.startx = roi.endx = roi.groupx = roi.starty = roi.endy = roi.groupy = 0;
+        if ( this->metadata.NumROI == 1 ) {
+            auto& roi = this->metadata.ROIinfoblk.front();
+            roi.endx = columns - 1;
+            roi.groupx = 1;
+            roi.endy = rows - 1;
+            roi.groupy = 1;
+        }
+    }
+
+    fileDescriptor = ::open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666 );
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + path + " could not be opened." );
+
+    try {
+        this->metadata.write( fileDescriptor );
+        if ( lseek( fileDescriptor, OFFSET_DATA, SEEK_SET ) < 0 ) throw std::runtime_error( "File " + path + " could not be written." );
+    } catch ( ... ) {
+        ::close( fileDescriptor );
+        throw;
+    }
+}
+
+Writer::~Writer()
+{
+    try {
+        close();
+    } catch ( ... ) {
+    }
+}
+
+/*!
+ * \param frame The frame to append
+ */
+void Writer::write( const Eigen::Ref<const Eigen::ArrayXXf>& frame )
+{
+    encodeFrame( frame );
+}
+
+/*!
+ * \param frames The stack of frames to append
+ */
+void Writer::write( const FrameStack& frames )
+{
+    for ( std::size_t frame = 0; frame < frames.frames(); ++frame ) encodeFrame( frames.frame( frame ) );
+}
+
+/*!
+ * \param file The SPE file to read the frames from
+ * \param first The index of the first frame to append, starts at 0
+ * \param count The number of frames to append
+ */
+void Writer::write( File& file, const long first, const long count )
+{
+    if ( file.rows() != metadata.ydim() or file.columns() != metadata.xdim() ) throw std::runtime_error( "Frame does not match the size of the frames in " + path + "." );
+    if ( first < 0 or count < 0 or first + count > long( file.frames() ) ) throw std::out_of_range( "Frame does not exist in the file." );
+
+    const long chunkFrames = std::max<std::size_t>( buffer.size() / std::max<std::size_t>( frameSize, 1 ), 1 );
+
+    if ( file.metadata.datatype() != metadata.datatype() ) {
+        for ( long chunk = 0; chunk < count; chunk += chunkFrames ) write( file.getFrames( first + chunk, std::min( chunkFrames, count - chunk ) ) );
+        return;
+    }
+
+    // Copy the stored bytes straight into the buffer
+    for ( long chunk = 0; chunk < count; chunk += chunkFrames ) {
+        const std::size_t frames = std::min( chunkFrames, count - chunk );
+        const std::size_t offset = OFFSET_DATA + ( frameSize * ( first + chunk ) );
+        if ( file.isMapped() ) {
+            if ( offset + ( frameSize * frames ) > file.mappingSize ) throw std::out_of_range( "Frame extends beyond the end of the file." );
+            std::copy_n( file.mapping + offset, frameSize * frames, reserve( frameSize * frames ) );
+        } else {
+            // Give the room back if the read fails, so no partly read frames are written out
+            char* room = reserve( frameSize * frames );
+            try {
+                file.readBytes( room, frameSize * frames, offset );
+            } catch ( ... ) {
+                used -= frameSize * frames;
+                throw;
+            }
+        }
+        m_frames += frames;
+    }
+}
+
+void Writer::close()
+{
+    if ( fileDescriptor < 0 ) return;
+
+    const int descriptor = fileDescriptor;
+    bool failed = false;
+    try {
+        flush();
+    } catch ( ... ) {
+        failed = true;
+    }
+    fileDescriptor = -1;
+
+    // Only the number of frames changes, so only those bytes of the header are written again
+    metadata.m_NumFrames = m_frames;
+    if ( m_frames > std::size_t( std::numeric_limits<std::int32_t>::max() ) ) failed = true;
+    if ( pwrite( descriptor, &metadata.m_NumFrames, sizeof( metadata.m_NumFrames ), OFFSET_NUMFRAMES ) != sizeof( metadata.m_NumFrames ) ) failed = true;
+    if ( ::close( descriptor ) != 0 ) failed = true;
+
+    if ( failed ) throw std::runtime_error( "File " + path + " could not be written." );
+}
+
+/*!
+ * \return The number of frames written so far
+ */
+std::size_t Writer::frames() const
+{
+    return m_frames;
+}
+
+/*!
+ * \param size The number of bytes to make room for
+ * \return The start of the room in the buffer
+ */
+char* Writer::reserve( const std::size_t size )
+{
+    if ( fileDescriptor < 0 ) throw std::runtime_error( "File " + path + " is already closed." );
+    if ( used + size > buffer.size() ) flush();
+
+    char* room = buffer.data() + used;
+    used += size;
+    return room;
+}
+
+void Writer::flush()
+{
+    const char* data = buffer.data();
+    std::size_t size = used;
+    used = 0;
+
+    while ( size > 0 ) {
+        const auto written = ::write( fileDescriptor, data, size );
+        if ( written < 0 and errno == EINTR ) continue;
+        if ( written <= 0 ) throw std::runtime_error( "File " + path + " could not be written." );
+
+        data += written;
+        size -= written;
+    }
+}
+}
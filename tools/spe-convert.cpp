@@ -0,0 +1,337 @@
+// This file is part of libSPE, a C++ library to interface with SPE files.
+//
+// Copyright (c) 2012,2013,2014,2015 Karthik Periagaram <dekonvoluted@gmail.com>
+//
+// libSPE is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// libSPE is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libSPE. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "spe.h"
+#include "dataset.h"
+#include "exporter.h"
+#include "textExporter.h"
+
+// Convert this many frames of a file in one task when writing every frame
+const long CHUNK_FRAMES = 16;
+
+// An SPE file to convert
+struct Input
+{
+    std::string path;
+    std::string output;
+    SPE::Probe probe;
+    std::size_t bytes = 0;
+    std::size_t tasks = 0;
+};
+
+// A piece of work: the average of a file, or a run of its frames
+struct Task
+{
+    std::size_t input;
+    long first;
+    long count;
+};
+
+// The files open for conversion, at most a given number at a time
+//
+// A file is opened by the first task that needs it and closed once its last task is done.
+// Tasks are handed out in file order, so every open file is being worked on and waiting for a free slot cannot deadlock.
+class OpenFiles
+{
+    public:
+    OpenFiles( const std::vector<Input>& inputs, const std::size_t limit ) : inputs( inputs ), limit( std::max<std::size_t>( limit, 1 ) ), files( inputs.size() ), opening( inputs.size(), false ), remaining( inputs.size() )
+    {
+        for ( std::size_t input = 0; input < inputs.size(); ++input ) remaining[ input ] = inputs[ input ].tasks;
+    }
+
+    // Get a file for a task, opening it if needed
+    SPE::File& acquire( const std::size_t input )
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        while ( true ) {
+            if ( files[ input ] ) return *files[ input ];
+
+            if ( not opening[ input ] and open < limit ) {
+                ++open;
+                opening[ input ] = true;
+                lock.unlock();
+
+                std::unique_ptr<SPE::File> file;
+                std::exception_ptr error;
+                try {
+                    file.reset( new SPE::File( inputs[ input ].path, true ) );
+                } catch ( ... ) {
+                    error = std::current_exception();
+                }
+
+                lock.lock();
+                opening[ input ] = false;
+                if ( error ) --open;
+                files[ input ] = std::move( file );
+                changed.notify_all();
+                if ( error ) std::rethrow_exception( error );
+                continue;
+            }
+
+            changed.wait( lock );
+        }
+    }
+
+    // Mark a task of a file as done, closing the file after its last task; returns whether that was the last task
+    bool release( const std::size_t input )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( --remaining[ input ] > 0 ) return false;
+
+        if ( files[ input ] ) {
+            files[ input ].reset();
+            --open;
+            changed.notify_all();
+        }
+        return true;
+    }
+
+    private:
+    const std::vector<Input>& inputs;
+    const std::size_t limit;
+    std::vector<std::unique_ptr<SPE::File>> files;
+    std::vector<bool> opening;
+    std::vector<std::size_t> remaining;
+    std::size_t open = 0;
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+// Write one frame as text, like the demo, or in a binary format
+void writeFrame( const std::string& path, const std::string& format, const int precision, const Eigen::Ref<const Eigen::ArrayXXf>& frame )
+{
+    if ( format == "npy" ) return SPE::Exporter::save( path + ".npy", frame, SPE::Exporter::NPY );
+    if ( format == "raw" ) return SPE::Exporter::save( path + ".raw", frame, SPE::Exporter::RAW );
+
+    SPE::TextExporter::save( path + ".dat", frame, precision );
+}
+
+// Pad a frame index with zeros to the width of the largest index
+std::string frameSuffix( const long frame, const long frames )
+{
+    const auto index = std::to_string( frame );
+    const auto width = std::to_string( std::max( frames - 1, 0l ) ).size();
+    return "_" + std::string( width - std::min( width, index.size() ), '0' ) + index;
+}
+
+void usage( const char* name )
+{
+    std::cerr << "Usage: " << name << " [-f] [-t format] [-p digits] [-o directory] [-j threads] [-n files] [-q] input..." << std::endl;
+    std::cerr << "Convert SPE files, or all SPE files in the given directories, to text or binary files." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "  -f            write every frame to its own file instead of the average of each file" << std::endl;
+    std::cerr << "  -t format     write text .dat files (dat, the default), NumPy .npy files (npy) or raw float32 .raw files (raw)" << std::endl;
+    std::cerr << "  -p digits     write this many significant digits to .dat files instead of the fewest that read back exactly" << std::endl;
+    std::cerr << "  -o directory  write the output files to this directory instead of next to the input files" << std::endl;
+    std::cerr << "  -j threads    the number of worker threads, one per core by default" << std::endl;
+    std::cerr << "  -n files      the number of files to keep open at once, one per worker thread by default" << std::endl;
+    std::cerr << "  -q            do not report each converted file" << std::endl;
+}
+
+int main( int argc, char* argv[] )
+{
+    bool perFrame = false;
+    bool quiet = false;
+    std::string outputDirectory;
+    std::string format = "dat";
+    int precision = 0;
+    unsigned threads = std::max( std::thread::hardware_concurrency(), 1u );
+    std::size_t openLimit = 0;
+
+    int option;
+    while ( ( option = getopt( argc, argv, "ft:p:o:j:n:qh" ) ) != -1 ) {
+        switch ( option ) {
+            case 'f':
+                perFrame = true;
+                break;
+            case 't':
+                format = optarg;
+                if ( format != "dat" and format != "npy" and format != "raw" ) {
+                    usage( argv[ 0 ] );
+                    return 2;
+                }
+                break;
+            case 'p':
+                precision = std::max( std::atoi( optarg ), 0 );
+                break;
+            case 'o':
+                outputDirectory = optarg;
+                break;
+            case 'j':
+                threads = std::max( std::atoi( optarg ), 1 );
+                break;
+            case 'n':
+                openLimit = std::max( std::atoi( optarg ), 1 );
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            default:
+                usage( argv[ 0 ] );
+                return option == 'h' ? 0 : 2;
+        }
+    }
+
+    if ( optind == argc ) {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    if ( not outputDirectory.empty() ) {
+        if ( mkdir( outputDirectory.c_str(), 0777 ) != 0 and errno != EEXIST ) {
+            std::cerr << "Directory " << outputDirectory << " could not be created." << std::endl;
+            return 1;
+        }
+        if ( outputDirectory.back() != '/' ) outputDirectory += '/';
+    }
+
+    // Gather the input files, expanding directories, and probe their sizes
+    std::vector<std::string> filePaths;
+    for ( auto argument = optind; argument < argc; ++argument ) {
+        struct stat status;
+        if ( stat( argv[ argument ], &status ) == 0 and S_ISDIR( status.st_mode ) ) {
+            try {
+                auto directoryPaths = SPE::Dataset::findFiles( argv[ argument ] );
+                filePaths.insert( filePaths.end(), directoryPaths.begin(), directoryPaths.end() );
+            } catch ( std::exception& error ) {
+                std::cerr << error.what() << std::endl;
+            }
+        } else {
+            filePaths.push_back( argv[ argument ] );
+        }
+    }
+
+    int status = 0;
+    std::vector<Input> inputs;
+    std::vector<Task> tasks;
+    for ( auto& filePath : filePaths ) {
+        Input input;
+        input.path = filePath;
+        input.probe = SPE::probe( filePath );
+        if ( not input.probe.valid ) {
+            std::cerr << "File " << filePath << " is not a valid SPE file, skipping." << std::endl;
+            status = 1;
+            continue;
+        }
+
+        if ( input.probe.NumFrames == 0 ) {
+            std::cerr << "File " << filePath << " has no frames, skipping." << std::endl;
+            continue;
+        }
+
+        input.bytes = std::size_t( input.probe.NumFrames ) * input.probe.xdim * input.probe.ydim * SPE::pixelSize( input.probe.datatype );
+
+        const auto slash = filePath.find_last_of( '/' );
+        const auto name = slash == std::string::npos ? filePath : filePath.substr( slash + 1 );
+        const auto directory = outputDirectory.empty() ? filePath.substr( 0, filePath.size() - name.size() ) : outputDirectory;
+        input.output = directory + name.substr( 0, std::min( name.size(), name.find_last_of( '.' ) ) );
+
+        if ( perFrame ) {
+            for ( long first = 0; first < input.probe.NumFrames; first += CHUNK_FRAMES ) {
+                tasks.push_back( Task{ inputs.size(), first, std::min<long>( CHUNK_FRAMES, input.probe.NumFrames - first ) } );
+                ++input.tasks;
+            }
+        } else {
+            tasks.push_back( Task{ inputs.size(), 0, input.probe.NumFrames } );
+            ++input.tasks;
+        }
+
+        inputs.push_back( input );
+    }
+
+    threads = std::max<std::size_t>( std::min<std::size_t>( threads, tasks.size() ), 1 );
+    const unsigned averageThreads = std::max<std::size_t>( threads / std::max<std::size_t>( inputs.size(), 1 ), 1 );
+    OpenFiles openFiles( inputs, openLimit ? openLimit : threads );
+
+    std::vector<bool> failed( inputs.size(), false );
+    std::atomic<std::size_t> nextTask( 0 );
+    std::mutex reportMutex;
+
+    auto convert = [&]() {
+        for ( auto next = nextTask++; next < tasks.size(); next = nextTask++ ) {
+            const Task& task = tasks[ next ];
+            const Input& input = inputs[ task.input ];
+
+            std::string error;
+            try {
+                SPE::File& file = openFiles.acquire( task.input );
+                if ( perFrame ) {
+                    const auto stack = file.getFrames( task.first, task.count );
+                    for ( long frame = 0; frame < task.count; ++frame ) {
+                        writeFrame( input.output + frameSuffix( task.first + frame, input.probe.NumFrames ), format, precision, stack.frame( frame ) );
+                    }
+                } else {
+                    writeFrame( input.output, format, precision, file.getAverageFrame( averageThreads ) );
+                }
+            } catch ( std::exception& exception ) {
+                error = exception.what();
+            }
+
+            const bool done = openFiles.release( task.input );
+
+            std::lock_guard<std::mutex> lock( reportMutex );
+            if ( not error.empty() and not failed[ task.input ] ) {
+                std::cerr << "File " << input.path << " could not be converted: " << error << std::endl;
+                failed[ task.input ] = true;
+            }
+            if ( done and not failed[ task.input ] and not quiet ) std::cout << input.path << " -> " << input.output << ( perFrame ? "_*." : "." ) << format << std::endl;
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for ( unsigned worker = 1; worker < threads; ++worker ) pool.emplace_back( convert );
+    convert();
+    for ( auto& thread : pool ) thread.join();
+
+    const auto stop = std::chrono::steady_clock::now();
+
+    // Report the throughput of the files that were converted
+    std::size_t files = 0, frames = 0, bytes = 0;
+    for ( std::size_t input = 0; input < inputs.size(); ++input ) {
+        if ( failed[ input ] ) {
+            status = 1;
+            continue;
+        }
+        ++files;
+        frames += inputs[ input ].probe.NumFrames;
+        bytes += inputs[ input ].bytes;
+    }
+
+    const auto seconds = std::max( std::chrono::duration<double>( stop - start ).count(), 1e-9 );
+    std::cout << "Converted " << files << " of " << filePaths.size() << " files, " << frames << " frames, " << bytes / 1e6 << " MB in " << seconds << " s: ";
+    std::cout << files / seconds << " files/s, " << bytes / 1e6 / seconds << " MB/s" << std::endl;
+
+    return status;
+}